@@ -6,11 +6,19 @@
 #include <iostream>
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <sstream>
 #include <algorithm>
 #include <numeric>
 #include <memory>
+#include <atomic>
 #include "BankAccount.h"
 #include "DateUtility.h"
+#include "Journal.h"
+#include "Idempotency.h"
+#include "MemoryFootprint.h"
+#include "Metrics.h"
+#include "Parallel.h"
 
 // Gunakan BankAccount dalam bentuk shared_ptr karena Bank memiliki daftar kepemilikan
 using BankAccountPtr = std::shared_ptr<BankAccount>;
@@ -18,12 +26,24 @@ using BankAccountPtr = std::shared_ptr<BankAccount>;
 class Bank
 {
 private:
-    std::map<std::string, BankAccountPtr> accounts; // Map: AccountId -> BankAccountPtr
-    std::map<std::string, std::string> customerMap; // Map: UserId -> AccountId
-    std::vector<Transaction> allTransactions;       // Semua transaksi bank (topup/withdraw/debit/credit)
+    std::map<Id, BankAccountPtr> accounts; // Map: AccountId -> BankAccountPtr
+    std::map<Id, Id> customerMap;          // Map: UserId -> AccountId
+    std::atomic<size_t> transactionCount{0};            // Jumlah transaksi bank (topup/withdraw); entrinya ada di Ledger
+    AnalyticsMode analyticsMode = AnalyticsMode::EXACT; // ROLLUP = laporan dari rollup harian akun
+    int cashFlowRetentionDays = 0;                      // 0 = cash flow disimpan selamanya
+    bool archiveCompactedCashFlow = false;              // Entri yang dipadatkan ditulis ke arsip di disk
+    std::atomic<size_t> lastTransactionNumber{0};       // Nomor ID transaksi bank terakhir yang dialokasikan
 
     // Konsep Singleton
-    Bank() = default;                       // Konstruktor pribadi
+    Bank()                                  // Konstruktor pribadi
+    {
+        // Gauge ukuran struktur data, dibaca saat metrics ditampilkan/diekspor
+        Metrics &metrics = Metrics::getInstance();
+        metrics.gauge("bank_accounts", "Jumlah akun bank", [this]()
+                      { return static_cast<double>(accounts.size()); });
+        metrics.gauge("bank_transactions", "Jumlah transaksi bank (topup/withdraw)", [this]()
+                      { return static_cast<double>(transactionCount.load()); });
+    }
     Bank(const Bank &) = delete;            // Non-copyable
     Bank &operator=(const Bank &) = delete; // Non-assignable
 
@@ -35,10 +55,13 @@ public:
         return instance;
     }
 
+    // displayCashFlow menampilkan sampai 30 hari terakhir, jadi retensi tidak boleh lebih pendek
+    static constexpr int MIN_CASH_FLOW_RETENTION_DAYS = 31;
+
     // --- Fungsionalitas Bank ---
 
     // 1. Create banking account [cite: 27]
-    BankAccountPtr createAccount(const std::string &userId)
+    BankAccountPtr createAccount(const Id &userId)
     {
         if (customerMap.count(userId))
         {
@@ -46,7 +69,7 @@ public:
             return accounts.at(customerMap.at(userId));
         }
 
-        std::string accountId = "BA_" + userId;
+        Id accountId = Id::join("BA_", userId);
         auto newAccount = std::make_shared<BankAccount>(accountId, userId);
 
         accounts[accountId] = newAccount;
@@ -54,24 +77,80 @@ public:
         return newAccount;
     }
 
+    // Kosongkan seluruh akun beserta entri Ledger-nya (read replica, sebelum memuat snapshot baru)
+    void clear()
+    {
+        accounts.clear();
+        customerMap.clear();
+        transactionCount = 0;
+        lastTransactionNumber = 0;
+        Ledger &ledger = Ledger::getInstance();
+        ledger.releaseBefore(ledger.end());
+    }
+
+    // Getter untuk Serialisasi
+    const std::map<Id, BankAccountPtr> &getAccounts() const
+    {
+        return accounts;
+    }
+
     // 2. Mendapatkan Akun
-    BankAccountPtr getAccount(const std::string &userId)
+    BankAccountPtr getAccount(const Id &userId)
     {
-        if (customerMap.count(userId))
+        auto it = customerMap.find(userId);
+        if (it != customerMap.end())
         {
-            return accounts.at(customerMap.at(userId));
+            return accounts.at(it->second);
         }
         return nullptr;
     }
 
     // 3. Memproses Topup/Withdraw (Transaksi Bank)
-    bool processBankTransaction(const std::string &userId, double amount, TransactionType type)
+    // idempotencyKey (opsional, dari client): retry dengan kunci yang sama mengembalikan hasil pertama
+    // tanpa mengubah saldo lagi.
+    bool processBankTransaction(const Id &userId, double amount, TransactionType type, const std::string &idempotencyKey = "")
     {
+        if (!idempotencyKey.empty())
+        {
+            std::string key = Idempotency::scopedKey(userId, idempotencyKey);
+            std::string request = Idempotency::requestOf(type == TransactionType::TOPUP ? "TOPUP" : "WITHDRAW", std::to_string(amount));
+            Idempotency::Result previous;
+            switch (Idempotency::getInstance().begin(key, request, previous))
+            {
+            case Idempotency::Status::REPLAY:
+                return previous.ok;
+            case Idempotency::Status::IN_PROGRESS:
+            case Idempotency::Status::CONFLICT:
+                return false;
+            case Idempotency::Status::NEW:
+                break;
+            }
+            bool ok = processBankTransaction(userId, amount, type);
+            Idempotency::getInstance().finish(key, {ok, std::string()});
+            return ok;
+        }
+
+        static Metrics::Histogram &latency = Metrics::getInstance().histogram("bank_transaction_seconds", "Latensi Bank::processBankTransaction");
+        static Metrics::Counter &bankOk = Metrics::getInstance().counter("bank_transaction_total", "Jumlah topup/withdraw per hasil", "result=\"ok\"");
+        static Metrics::Counter &accountNotFound = Metrics::getInstance().counter("bank_transaction_total", "Jumlah topup/withdraw per hasil", "result=\"account_not_found\"");
+        static Metrics::Counter &rejected = Metrics::getInstance().counter("bank_transaction_total", "Jumlah topup/withdraw per hasil", "result=\"rejected\"");
+        Metrics::ScopedTimer timer(latency);
+
         BankAccountPtr account = getAccount(userId);
         if (!account)
+        {
+            accountNotFound.increment();
             return false;
+        }
 
-        std::string tId = "T" + std::to_string(allTransactions.size() + 1);
+        // ID dialokasikan tanpa lock (compare-exchange), karena topup/withdraw berjalan di beberapa thread shard
+        size_t last = lastTransactionNumber.load();
+        size_t number;
+        do
+        {
+            number = std::max(last, transactionCount.load()) + 1;
+        } while (!lastTransactionNumber.compare_exchange_weak(last, number));
+        Id tId = Id::numbered("T", number);
         bool success = false;
 
         if (type == TransactionType::TOPUP)
@@ -85,65 +164,295 @@ public:
 
         if (success)
         {
-            // Karena cashFlow di BankAccount sudah mencatat transaksi ini,
-            // kita bisa mencatatnya di Bank untuk tujuan Bank Listing (List all transaction within a week)
-            // Namun, untuk membedakan antara transaksi Toko dan Bank, kita akan ambil dari cashFlow saja.
-            // Di sini, kita hanya akan mencatat transaksi Bank inti (Topup/Withdraw)
-            allTransactions.emplace_back(tId, userId, amount, type);
+            // Entri transaksi sudah dicatat sekali di Ledger lewat akun (Bank Listing membaca cash flow akun);
+            // Bank hanya menghitung transaksi inti (Topup/Withdraw) untuk penomoran ID
+            transactionCount++;
+            Journal::getInstance().advance();
         }
+        else
+        {
+            size_t expected = number;
+            lastTransactionNumber.compare_exchange_strong(expected, number - 1); // Kembalikan nomor yang tidak terpakai
+        }
+        (success ? bankOk : rejected).increment(); // rejected: jumlah tidak valid / saldo tidak cukup
         return success;
     }
 
+    size_t getTransactionCount() const
+    {
+        return transactionCount;
+    }
+
+    // Impor massal pergerakan dana historis (topup/withdraw/debit/kredit dengan waktu asli).
+    // Batch diurutkan menurut waktu, kapasitas cash flow disiapkan sekali per akun, tanpa output per record.
+    // Record untuk user tanpa akun, atau yang tanda jumlahnya bertentangan dengan tipenya (mis. WITHDRAW positif),
+    // dilewati. Mengembalikan jumlah record yang diterapkan.
+    size_t importTransactions(std::vector<Transaction> &&batch)
+    {
+        std::stable_sort(batch.begin(), batch.end(), [](const Transaction &a, const Transaction &b)
+                         { return a.getDate() < b.getDate(); });
+
+        std::unordered_map<Id, std::pair<BankAccount *, size_t>> targets; // UserId -> (akun, jumlah record)
+        for (const Transaction &t : batch)
+        {
+            auto res = targets.try_emplace(t.getBuyerId(), nullptr, 0);
+            if (res.second)
+            {
+                auto it = customerMap.find(t.getBuyerId());
+                res.first->second.first = it == customerMap.end() ? nullptr : accounts.at(it->second).get();
+            }
+            res.first->second.second++;
+        }
+        for (auto &pair : targets)
+        {
+            if (pair.second.first)
+                pair.second.first->reserveCashFlow(pair.second.second);
+        }
+
+        size_t applied = 0;
+        for (Transaction &t : batch)
+        {
+            BankAccount *account = targets.at(t.getBuyerId()).first;
+            if (account && account->recordHistorical(t))
+                applied++;
+        }
+        transactionCount += applied;
+        return applied;
+    }
+
+    // Catat transaksi bank historis (topup/withdraw) ke akun pemiliknya (generator)
+    void recordHistoricalTransaction(BankAccount &account, const Transaction &t)
+    {
+        if (account.recordHistorical(t))
+            transactionCount++;
+    }
+
     // 4. Proses Transfer (Digunakan oleh Store)
     // Transfer dari pembeli (debit) ke penjual (credit)
-    bool transfer(const std::string &buyerId, const std::string &sellerId, double amount, const std::string &tId)
+    bool transfer(const Id &buyerId, const Id &sellerId, double amount, const Id &tId)
     {
+        static Metrics::Histogram &latency = Metrics::getInstance().histogram("bank_transfer_seconds", "Latensi Bank::transfer");
+        static Metrics::Counter &transferOk = Metrics::getInstance().counter("bank_transfer_total", "Jumlah transfer per hasil", "result=\"ok\"");
+        static Metrics::Counter &accountNotFound = Metrics::getInstance().counter("bank_transfer_total", "Jumlah transfer per hasil", "result=\"account_not_found\"");
+        static Metrics::Counter &insufficientBalance = Metrics::getInstance().counter("bank_transfer_total", "Jumlah transfer per hasil", "result=\"insufficient_balance\"");
+        Metrics::ScopedTimer timer(latency);
+
         BankAccountPtr buyerAcc = getAccount(buyerId);
         BankAccountPtr sellerAcc = getAccount(sellerId);
 
         if (!buyerAcc || !sellerAcc)
+        {
+            accountNotFound.increment();
             return false;
+        }
 
-        // 1. Debet dari Pembeli
-        if (!buyerAcc->debit(amount, tId))
+        // Debet dari Pembeli dan Kredit ke Penjual di bawah lock kedua akun
+        if (!BankAccount::transfer(*buyerAcc, *sellerAcc, amount, tId))
         {
+            insufficientBalance.increment();
             return false; // Saldo tidak cukup
         }
 
-        // 2. Kredit ke Penjual
-        sellerAcc->credit(amount, tId);
-
-        // Transaksi ini adalah transaksi toko (PURCHASE), jadi kita tidak mencatatnya di allTransactions Bank
+        // Transaksi ini adalah transaksi toko (PURCHASE), jadi tidak dihitung sebagai transaksi Bank
         // agar tidak tumpang tindih dengan pencatatan Store.
 
+        transferOk.increment();
+        return true;
+    }
+
+    // Transfer dua fase untuk mode shard (lihat ShardEngine.h). prepareTransfer mendebit pembeli di shard
+    // pembeli; commitTransfer mengkredit penjual di shard penjual sebagai pesan terpisah. Commit tidak bisa
+    // gagal, sehingga dana yang sudah didebit pasti sampai; di antara kedua fase dana sedang "dalam perjalanan".
+    // Kedua fase mencatat sisi berbeda dari satu entri Ledger ('entry', diisi prepareTransfer).
+    bool prepareTransfer(const Id &buyerId, const Id &sellerId, double amount, const Id &tId, Ledger::Position &entry)
+    {
+        static Metrics::Counter &accountNotFound = Metrics::getInstance().counter("bank_transfer_total", "Jumlah transfer per hasil", "result=\"account_not_found\"");
+        static Metrics::Counter &insufficientBalance = Metrics::getInstance().counter("bank_transfer_total", "Jumlah transfer per hasil", "result=\"insufficient_balance\"");
+
+        BankAccountPtr buyerAcc = getAccount(buyerId);
+        if (!buyerAcc || !getAccount(sellerId))
+        {
+            accountNotFound.increment();
+            return false;
+        }
+        if (!buyerAcc->debit(amount, tId, entry))
+        {
+            insufficientBalance.increment();
+            return false;
+        }
         return true;
     }
 
+    void commitTransfer(const Id &sellerId, Ledger::Position entry)
+    {
+        static Metrics::Counter &transferOk = Metrics::getInstance().counter("bank_transfer_total", "Jumlah transfer per hasil", "result=\"ok\"");
+        getAccount(sellerId)->credit(entry); // Akun penjual sudah dicek di prepareTransfer
+        transferOk.increment();
+    }
+
+    // 5. Pembalikan Transfer (Digunakan oleh Store untuk cancel/refund pesanan)
+    // Kebalikan dari transfer: debit dari penjual, kredit ke pembeli
+    bool reverseTransfer(const Id &buyerId, const Id &sellerId, double amount, const Id &tId)
+    {
+        BankAccountPtr buyerAcc = getAccount(buyerId);
+        BankAccountPtr sellerAcc = getAccount(sellerId);
+
+        if (!buyerAcc || !sellerAcc)
+            return false;
+
+        // Debet dari Penjual (gagal jika saldo penjual sudah ditarik), lalu kredit kembali ke Pembeli
+        return BankAccount::transfer(*sellerAcc, *buyerAcc, amount, tId);
+    }
+
     // --- Fungsionalitas Listing Bank ---
 
+    // Pointer ke seluruh akun sesuai urutan ID, agar bisa dipartisi untuk laporan paralel
+    std::vector<const BankAccount *> accountView() const
+    {
+        std::vector<const BankAccount *> view;
+        view.reserve(accounts.size());
+        for (const auto &pair : accounts)
+            view.push_back(pair.second.get());
+        return view;
+    }
+
+    // --- Retensi Cash Flow ---
+
+    // days = 0 menonaktifkan pemadatan; nilai lain dinaikkan ke MIN_CASH_FLOW_RETENTION_DAYS
+    void setCashFlowRetention(int days, bool archive)
+    {
+        cashFlowRetentionDays = days <= 0 ? 0 : std::max(days, MIN_CASH_FLOW_RETENTION_DAYS);
+        archiveCompactedCashFlow = cashFlowRetentionDays > 0 && archive;
+    }
+
+    int getCashFlowRetentionDays() const { return cashFlowRetentionDays; }
+    bool isCashFlowArchived() const { return archiveCompactedCashFlow; }
+
+    // Batas masa retensi saat ini (dihitung dari awal hari ini); 0 jika retensi nonaktif
+    time_t cashFlowHorizon() const
+    {
+        if (cashFlowRetentionDays <= 0)
+            return 0;
+        return DateUtility::startOfDay(DateUtility::getCurrentTime()) - static_cast<time_t>(cashFlowRetentionDays) * 86400;
+    }
+
+    // Entri (OwnerId, transaksi) yang akan dipadatkan compactCashFlows(horizon), agar bisa diarsipkan lebih dulu
+    void collectCompactable(time_t horizon, std::vector<std::pair<Id, Transaction>> &out) const
+    {
+        for (const auto &pair : accounts)
+        {
+            for (Transaction &t : pair.second->getCashFlowBefore(horizon))
+                out.emplace_back(pair.second->getOwnerId(), std::move(t));
+        }
+    }
+
+    // Padatkan cash flow semua akun yang lebih tua dari horizon ke checkpoint bulanan.
+    // Biaya O(jumlah akun) jika tidak ada entri yang melewati horizon.
+    size_t compactCashFlows(time_t horizon)
+    {
+        if (horizon <= 0)
+            return 0;
+        size_t folded = 0;
+        Ledger &ledger = Ledger::getInstance();
+        Ledger::Position keep = ledger.end();
+        for (const auto &pair : accounts)
+        {
+            if (size_t count = pair.second->compactCashFlow(horizon))
+            {
+                folded += count;
+                ChangeTracker::getInstance().markAccount(pair.second->getOwnerId()); // Cash flow & checkpoint berubah
+            }
+            keep = std::min(keep, pair.second->oldestLedgerPosition());
+        }
+        // Cash flow akun adalah satu-satunya view Ledger, jadi entri di bawah 'keep' tidak dipakai lagi
+        ledger.releaseBefore(keep);
+        return folded;
+    }
+
+    // Perkiraan memori struktur Bank (lihat MemoryFootprint.h)
+    void memoryUsage(MemoryFootprint::Report &report) const
+    {
+        using MF = MemoryFootprint;
+        MF::Usage accountUsage{"bank.accounts", accounts.size(), 0};
+        MF::Usage cashFlowUsage{"bank.account_cash_flow", 0, 0};
+        for (const auto &pair : accounts)
+        {
+            const BankAccount &account = *pair.second;
+            accountUsage.bytes += MF::treeNode<std::pair<const Id, BankAccountPtr>>() + MF::shared<BankAccount>();
+            cashFlowUsage.elements += account.cashFlowSize();
+            cashFlowUsage.bytes += account.cashFlowMemoryBytes();
+        }
+
+        MF::Usage customerUsage{"bank.customer_map", customerMap.size(), customerMap.size() * MF::treeNode<std::pair<const Id, Id>>()};
+
+        report.push_back(accountUsage);
+        report.push_back(customerUsage);
+        report.push_back(Ledger::getInstance().memoryUsage());
+        report.push_back(cashFlowUsage);
+    }
+
+    // Ringkasan topup/withdraw per akun dari rollup harian (hari penuh sejak awal hari dari 'since')
+    void printCashFlowTotals(time_t since) const
+    {
+        std::map<Id, std::pair<double, double>> totals; // OwnerId -> (topup, withdraw)
+        DailyRollups::getInstance().forEachDaySince(DailyRollups::dayOf(since), [&](int64_t, const DayRollup &day)
+                                                    {
+            for (const auto &pair : day.accounts)
+            {
+                if (pair.second.topup == 0.0 && pair.second.withdraw == 0.0)
+                    continue;
+                totals[pair.first].first += pair.second.topup;
+                totals[pair.first].second += pair.second.withdraw;
+            } });
+        for (const auto &pair : totals)
+        {
+            auto it = customerMap.find(pair.first);
+            std::cout << "Akun: " << (it != customerMap.end() ? it->second : "N/A")
+                      << " | Pemilik: " << pair.first
+                      << " | Total Topup: +" << pair.second.first
+                      << " | Total Withdraw: -" << pair.second.second << std::endl;
+        }
+        if (totals.empty())
+            std::cout << "Tidak ada topup/withdraw." << std::endl;
+    }
+
+    void setAnalyticsMode(AnalyticsMode mode) { analyticsMode = mode; }
+
     // List all transaction within a week starting from nowon backwards [cite: 22]
     void listTransactionsWithinAWeek() const
     {
         time_t oneWeekAgo = DateUtility::getPastDays(7);
-        std::cout << "\n--- Transaksi Bank (Topup/Withdraw) dalam Seminggu Terakhir ---" << std::endl;
-
-        for (const auto &accPair : accounts)
+        if (analyticsMode == AnalyticsMode::ROLLUP)
         {
-            const auto &account = accPair.second;
-            const auto &cashFlow = account->getCashFlow();
+            std::cout << "\n--- Total Topup/Withdraw per Akun dalam Seminggu Terakhir (Rollup Harian) ---" << std::endl;
+            printCashFlowTotals(oneWeekAgo);
+            return;
+        }
+        std::cout << "\n--- Transaksi Bank (Topup/Withdraw) dalam Seminggu Terakhir ---" << std::endl;
 
-            for (const auto &t : cashFlow)
+        // Akun dipartisi antar thread, output tiap partisi dicetak berurutan
+        std::vector<const BankAccount *> view = accountView();
+        auto parts = Parallel::mapRanges<std::ostringstream>(view.size(), [&](size_t begin, size_t end, std::ostringstream &out)
+                                                             {
+            for (size_t i = begin; i < end; ++i)
             {
-                // Hanya tampilkan Topup/Withdraw yang terjadi dalam seminggu
-                if (t.getDate() >= oneWeekAgo && (t.getType() == TransactionType::TOPUP || t.getType() == TransactionType::WITHDRAW))
-                {
-                    std::cout << DateUtility::timeToString(t.getDate())
-                              << " | Akun: " << account->getId()
-                              << " | Tipe: " << (t.getType() == TransactionType::TOPUP ? "TOPUP" : "WITHDRAW")
-                              << " | Jumlah: " << (t.getAmount() > 0 ? "+" : "") << t.getAmount() << std::endl;
-                }
-            }
+                const BankAccount *account = view[i];
+                account->forEachCashFlow([&](const LedgerEntry &entry, double amount)
+                                         {
+                    // Hanya tampilkan Topup/Withdraw yang terjadi dalam seminggu
+                    if (entry.date >= oneWeekAgo && (entry.type == TransactionType::TOPUP || entry.type == TransactionType::WITHDRAW))
+                    {
+                        out << DateUtility::timeToString(entry.date)
+                            << " | Akun: " << account->getId()
+                            << " | Tipe: " << (entry.type == TransactionType::TOPUP ? "TOPUP" : "WITHDRAW")
+                            << " | Jumlah: " << (amount > 0 ? "+" : "") << amount << "\n";
+                    } });
+            } }, 1024);
+        for (const auto &part : parts)
+        {
+            std::cout << part.str();
         }
+        std::cout.flush();
     }
 
     // List all bank customers [cite: 23]
@@ -166,10 +475,10 @@ public:
         for (const auto &accPair : accounts)
         {
             const auto &account = accPair.second;
-            const auto &cashFlow = account->getCashFlow();
+            time_t last = account->lastActivity(); // Termasuk entri yang sudah dipadatkan
 
             // Cek transaksi terakhir (kita asumsikan cashFlow selalu terurut berdasarkan tanggal)
-            if (cashFlow.empty() || cashFlow.back().getDate() < oneMonthAgo)
+            if (last == 0 || last < oneMonthAgo)
             {
                 std::cout << "Akun ID: " << account->getId() << " | Pemilik: " << account->getOwnerId() << std::endl;
                 count++;
@@ -185,24 +494,45 @@ public:
     void listTopNUsersToday(int n) const
     {
         // Peta: UserID -> Jumlah Transaksi Hari Ini
-        std::map<std::string, int> userTransactionCount;
-        time_t startOfToday = DateUtility::getCurrentTime() - (std::time(nullptr) % 86400); // Kira-kira awal hari
+        std::map<Id, int> userTransactionCount;
+        time_t startOfToday = DateUtility::startOfDay(DateUtility::getCurrentTime()); // Awal hari (UTC)
 
-        // Iterasi semua cash flow dari semua akun
-        for (const auto &accPair : accounts)
+        if (analyticsMode == AnalyticsMode::ROLLUP)
         {
-            const auto &account = accPair.second;
-            for (const auto &t : account->getCashFlow())
-            {
-                if (t.getDate() >= startOfToday)
+            // Hanya hari ini: satu entri rollup per akun yang aktif
+            DailyRollups::getInstance().forEachDaySince(DailyRollups::dayOf(startOfToday), [&](int64_t, const DayRollup &day)
+                                                        {
+                for (const auto &pair : day.accounts)
                 {
-                    userTransactionCount[account->getOwnerId()]++;
-                }
+                    if (pair.second.count > 0)
+                        userTransactionCount[pair.first] += static_cast<int>(pair.second.count);
+                } });
+        }
+        else
+        {
+            // Iterasi semua cash flow dari semua akun: hitungan per partisi akun di map lokal, lalu digabung
+            std::vector<const BankAccount *> view = accountView();
+            auto partials = Parallel::mapRanges<std::unordered_map<Id, int>>(view.size(), [&](size_t begin, size_t end, std::unordered_map<Id, int> &local)
+                                                                             {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    int count = 0;
+                    view[i]->forEachCashFlow([&](const LedgerEntry &entry, double)
+                                             {
+                        if (entry.date >= startOfToday)
+                            count++; });
+                    if (count > 0)
+                        local[view[i]->getOwnerId()] += count;
+                } }, 1024);
+            for (const auto &local : partials)
+            {
+                for (const auto &pair : local)
+                    userTransactionCount[pair.first] += pair.second;
             }
         }
 
         // Konversi ke vektor pasangan (count, userId) untuk sorting
-        std::vector<std::pair<int, std::string>> sortedUsers;
+        std::vector<std::pair<int, Id>> sortedUsers;
         for (const auto &pair : userTransactionCount)
         {
             sortedUsers.push_back({pair.second, pair.first});
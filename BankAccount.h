@@ -6,75 +6,306 @@
 #include <string>
 #include <vector>
 #include <numeric>
+#include <algorithm>
+#include <mutex>
 #include "Transaction.h"
+#include "Ledger.h"
+#include "ChangeTracker.h"
+#include "DailyRollups.h"
 
+// Ringkasan cash flow satu bulan (UTC) yang sudah dipadatkan (lihat compactCashFlow)
+struct CashFlowCheckpoint {
+    int64_t month;         // DateUtility::monthOf
+    double openingBalance; // Saldo sebelum entri pertama bulan ini yang dipadatkan
+    int64_t count = 0;
+    double topup = 0.0;
+    double withdraw = 0.0; // Disimpan positif
+    double debit = 0.0;    // Pembayaran pembelian (disimpan positif)
+    double credit = 0.0;   // Penerimaan dari penjualan / refund
+    time_t lastDate = 0;   // Waktu entri terakhir yang dipadatkan
+};
+
+// Aman dipakai paralel: setiap akun punya lock sendiri, sehingga operasi pada akun berbeda tidak saling
+// menunggu. Operasi yang menyentuh dua akun (transfer) mengunci keduanya dalam urutan global (AccountId).
+// Di dalam lock akun hanya saldo, view cash flow, dan append Ledger (tanpa lock); rollup harian dan
+// ChangeTracker diperbarui setelah lock akun dilepas (lihat settle).
 class BankAccount {
 private:
-    std::string accountId;
-    std::string ownerId;
+    mutable std::mutex mtx;  // Melindungi balance, cashFlow, dan version
+    Id accountId;
+    Id ownerId;
     double balance;
-    std::vector<Transaction> cashFlow; // List cash flow (credit/debit) 
+    std::vector<Ledger::Ref> cashFlow; // View cash flow (credit/debit): referensi ke entri Ledger, urut dicatat
+    std::vector<CashFlowCheckpoint> checkpoints; // Entri lama yang sudah dipadatkan per bulan (urut bulan)
+    uint64_t version;                  // Naik setiap saldo berubah (untuk checkpoint inkremental)
+    Ledger::Position oldestPosition = UINT64_MAX; // Posisi Ledger terkecil yang direferensikan cashFlow
+
+    static const LedgerEntry& entryOf(Ledger::Ref ref) {
+        return Ledger::getInstance().at(Ledger::positionOf(ref));
+    }
+
+    // Sisi akun dari satu entri cash flow, diteruskan ke settle setelah lock akun dilepas
+    struct Posting {
+        time_t date;
+        TransactionType type;
+        double amount; // Bertanda dari sudut pandang akun ini
+    };
+
+    // Semua entri cash flow lewat sini: saldo berubah sebesar sisi akun ini dari entri Ledger.
+    // Pemanggil memegang mtx, lalu memanggil settle(posting) setelah melepasnya.
+    Posting postLocked(Ledger::Ref ref) {
+        const LedgerEntry& entry = entryOf(ref);
+        double amount = Ledger::signedAmount(entry, ref);
+        balance += amount;
+        cashFlow.push_back(ref);
+        oldestPosition = std::min(oldestPosition, Ledger::positionOf(ref));
+        return Posting{entry.date, entry.type, amount};
+    }
+
+    // Perbarui rollup harian akun (dan tandai akun berubah untuk checkpoint jika markDirty) di luar lock
+    // akun, agar lock global DailyRollups/ChangeTracker tidak ikut menahan operasi lain pada akun ini.
+    void settle(const Posting& posting, bool markDirty = true) const {
+        DailyRollups::getInstance().applyCashFlow(ownerId, posting.date, posting.type, posting.amount);
+        if (markDirty) ChangeTracker::getInstance().markAccount(ownerId);
+    }
+
+    time_t lastActivityLocked() const {
+        if (!cashFlow.empty()) return entryOf(cashFlow.back()).date;
+        return checkpoints.empty() ? 0 : checkpoints.back().lastDate;
+    }
+
+    // Versi tanpa lock; pemanggil sudah memegang mtx
+    bool canDebitLocked(double amount) const { return amount > 0 && balance >= amount; }
+
+    // Entri cash flow sebagai Transaction bank (sudut pandang akun ini)
+    Transaction materialize(Ledger::Ref ref) const {
+        const LedgerEntry& entry = entryOf(ref);
+        return Transaction(entry.transactionId, "N/A", ownerId, "N/A", Ledger::signedAmount(entry, ref), 1,
+                           entry.date, TransactionStatus::COMPLETED, entry.type);
+    }
 
 public:
-    BankAccount(const std::string& accId, const std::string& ownId) 
-        : accountId(accId), ownerId(ownId), balance(0.0) {}
+    BankAccount(const Id& accId, const Id& ownId) 
+        : accountId(accId), ownerId(ownId), balance(0.0), version(0) {}
 
     // Getter
-    std::string getId() const { return accountId; }
-    std::string getOwnerId() const { return ownerId; }
-    double getBalance() const { return balance; }
-    const std::vector<Transaction>& getCashFlow() const { return cashFlow; }
+    const Id& getId() const { return accountId; }
+    const Id& getOwnerId() const { return ownerId; }
+    double getBalance() const { std::lock_guard<std::mutex> lock(mtx); return balance; }
+    uint64_t getVersion() const { std::lock_guard<std::mutex> lock(mtx); return version; }
+    // Panggil fn(LedgerEntry, amount) untuk setiap entri cash flow (amount bertanda dari sudut pandang akun).
+    // Tanpa lock: hanya untuk laporan yang berjalan saat tidak ada operasi bank lain (engine lock / exclusive)
+    template <typename Fn>
+    void forEachCashFlow(Fn fn) const {
+        for (Ledger::Ref ref : cashFlow) {
+            const LedgerEntry& entry = entryOf(ref);
+            fn(entry, Ledger::signedAmount(entry, ref));
+        }
+    }
+
+    // Pulihkan saldo dari file (tanpa entri cash flow baru)
+    void restoreBalance(double b) { std::lock_guard<std::mutex> lock(mtx); balance = b; }
+
+    // Catat pergerakan dana historis (impor/generator) apa adanya sebagai satu entri Ledger: saldo 'from'
+    // berkurang dan saldo 'to' bertambah tanpa validasi saldo. Salah satu pihak boleh nullptr (dana dari/ke
+    // luar bank, mis. topup/withdraw). Entri harus ditambahkan berurutan menurut waktu.
+    static Ledger::Position recordHistoricalTransfer(BankAccount* from, BankAccount* to, double amount, const Id& tId,
+                                                     time_t date, TransactionType type) {
+        Ledger::Position position = Ledger::getInstance().append(tId, amount, type, date);
+        if (from) {
+            Posting posting;
+            { std::lock_guard<std::mutex> lock(from->mtx); posting = from->postLocked(Ledger::outgoing(position)); }
+            from->settle(posting, false);
+        }
+        if (to) {
+            Posting posting;
+            { std::lock_guard<std::mutex> lock(to->mtx); posting = to->postLocked(Ledger::incoming(position)); }
+            to->settle(posting, false);
+        }
+        return position;
+    }
+
+    // Record cash flow satu sisi (ItemID "N/A"): amount positif = dana masuk, negatif = keluar.
+    // Ditolak (false) jika tanda bertentangan dengan tipe: TOPUP selalu masuk, WITHDRAW selalu keluar.
+    bool recordHistorical(const Transaction& t) {
+        bool in = t.getAmount() >= 0;
+        if ((t.getType() == TransactionType::TOPUP && !in) || (t.getType() == TransactionType::WITHDRAW && t.getAmount() > 0))
+            return false;
+        recordHistoricalTransfer(in ? nullptr : this, in ? this : nullptr, in ? t.getAmount() : -t.getAmount(),
+                                 t.getId(), t.getDate(), t.getType());
+        return true;
+    }
+
+    // Siapkan kapasitas cash flow sebelum impor massal
+    void reserveCashFlow(size_t additional) { std::lock_guard<std::mutex> lock(mtx); cashFlow.reserve(cashFlow.size() + additional); }
 
     // Metode Utama
-    bool topup(double amount, const std::string& tId) { // Topup [cite: 29]
-        if (amount > 0) {
-            balance += amount;
-            // Catat sebagai transaksi Bank: TOPUP
-            cashFlow.emplace_back(tId, ownerId, amount, TransactionType::TOPUP); 
-            return true;
+    bool topup(double amount, const Id& tId) { // Topup [cite: 29]
+        if (amount <= 0) return false;
+        // Catat sebagai transaksi Bank: TOPUP (tidak perlu validasi saldo, jadi append di luar lock akun)
+        Ledger::Position entry = Ledger::getInstance().append(tId, amount, TransactionType::TOPUP);
+        Posting posting;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            posting = postLocked(Ledger::incoming(entry));
+            version++;
         }
-        return false;
+        settle(posting);
+        return true;
     }
 
-    bool withdraw(double amount, const std::string& tId) { // Withdraw [cite: 30]
+    bool withdraw(double amount, const Id& tId) { // Withdraw [cite: 30]
         // Cek batasan saldo: "Limited by balance" [cite: 37]
-        if (amount > 0 && balance >= amount) {
-            balance -= amount;
-            // Catat sebagai transaksi Bank: WITHDRAW
-            cashFlow.emplace_back(tId, ownerId, -amount, TransactionType::WITHDRAW); // -amount untuk debit
-            return true;
+        Posting posting;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (!canDebitLocked(amount)) return false;
+            // Catat sebagai transaksi Bank: WITHDRAW (sisi keluar, -amount di cash flow)
+            posting = postLocked(Ledger::outgoing(Ledger::getInstance().append(tId, amount, TransactionType::WITHDRAW)));
+            version++;
+        }
+        settle(posting);
+        return true;
+    }
+
+    // Metode untuk memproses pembayaran (Debet). Pembayaran dicatat sebagai entri Ledger baru (posisinya
+    // dikembalikan lewat 'entry'); penerima mencatat sisi masuk entri yang sama lewat credit(entry).
+    // Transaksi pembelian dicatat terpisah di Store, ini hanya pergerakan uang.
+    bool debit(double amount, const Id& tId, Ledger::Position& entry) {
+        Posting posting;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (!canDebitLocked(amount)) return false;
+            entry = Ledger::getInstance().append(tId, amount, TransactionType::PURCHASE);
+            posting = postLocked(Ledger::outgoing(entry));
+            version++;
         }
-        return false;
+        settle(posting);
+        return true;
     }
 
-    // Metode untuk memproses pembayaran (Debet)
-    bool debit(double amount, const std::string& tId) {
-        if (amount > 0 && balance >= amount) {
-            balance -= amount;
-            // Transaksi pembelian akan dicatat terpisah di Store, ini hanya pergerakan uang
-            cashFlow.emplace_back(tId, ownerId, -amount, TransactionType::PURCHASE);
-            return true;
+    // Metode untuk menerima pembayaran (Kredit) dari entri yang sudah didebit
+    void credit(Ledger::Position entry) {
+        Posting posting;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            posting = postLocked(Ledger::incoming(entry));
+            version++;
         }
-        return false;
+        settle(posting);
     }
 
-    // Metode untuk menerima pembayaran (Kredit)
-    bool credit(double amount, const std::string& tId) {
-        if (amount > 0) {
-            balance += amount;
-            // Transaksi penjualan akan dicatat terpisah di Store
-            cashFlow.emplace_back(tId, ownerId, amount, TransactionType::PURCHASE);
-            return true;
+    // Debit 'from' dan kredit 'to' sebagai satu langkah atomik: pembaca lain tidak pernah melihat dana
+    // yang sudah keluar dari 'from' tetapi belum masuk ke 'to'. Kedua sisi mereferensikan satu entri Ledger.
+    // Kedua lock diambil urut AccountId agar dua transfer berlawanan arah tidak deadlock.
+    static bool transfer(BankAccount& from, BankAccount& to, double amount, const Id& tId) {
+        std::unique_lock<std::mutex> first, second;
+        if (&from == &to) {
+            first = std::unique_lock<std::mutex>(from.mtx);
+        } else {
+            bool fromFirst = from.accountId < to.accountId;
+            first = std::unique_lock<std::mutex>(fromFirst ? from.mtx : to.mtx);
+            second = std::unique_lock<std::mutex>(fromFirst ? to.mtx : from.mtx);
         }
-        return false;
+        if (!from.canDebitLocked(amount))
+            return false;
+        Ledger::Position entry = Ledger::getInstance().append(tId, amount, TransactionType::PURCHASE);
+        Posting outgoing = from.postLocked(Ledger::outgoing(entry));
+        from.version++;
+        Posting incoming = to.postLocked(Ledger::incoming(entry));
+        to.version++;
+        if (second.owns_lock()) second.unlock();
+        first.unlock();
+        from.settle(outgoing);
+        to.settle(incoming);
+        return true;
+    }
+
+    // Perkiraan memori view cash flow (referensi + checkpoint bulanan; isi entri dihitung di Ledger)
+    size_t cashFlowMemoryBytes() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        return MemoryFootprint::buffer(cashFlow) + MemoryFootprint::buffer(checkpoints);
+    }
+
+    // Posisi Ledger terkecil yang masih direferensikan akun ini (UINT64_MAX jika tidak ada)
+    Ledger::Position oldestLedgerPosition() const { std::lock_guard<std::mutex> lock(mtx); return oldestPosition; }
+
+    size_t cashFlowSize() const { std::lock_guard<std::mutex> lock(mtx); return cashFlow.size(); }
+
+    // Padatkan entri cash flow yang lebih tua dari horizon ke checkpoint bulanan, sehingga memori akun
+    // sebanding dengan jumlah entri dalam masa retensi (+ satu checkpoint per bulan). Entri yang akan dibuang
+    // bisa diambil lebih dulu lewat getCashFlowBefore (arsip). Mengembalikan jumlah entri yang dipadatkan.
+    // Entri diasumsikan urut waktu; pengecekan awal O(1) jika tidak ada yang perlu dipadatkan.
+    // Entri Ledger yang tidak lagi direferensikan dilepas oleh Bank::compactCashFlows.
+    size_t compactCashFlow(time_t horizon) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (cashFlow.empty() || entryOf(cashFlow.front()).date >= horizon) return 0;
+
+        size_t cut = 0;
+        while (cut < cashFlow.size() && entryOf(cashFlow[cut]).date < horizon) cut++;
+
+        // Saldo sebelum entri cash flow pertama yang masih tersimpan
+        double running = balance;
+        for (Ledger::Ref ref : cashFlow) running -= Ledger::signedAmount(entryOf(ref), ref);
+
+        for (size_t i = 0; i < cut; ++i) {
+            const LedgerEntry& entry = entryOf(cashFlow[i]);
+            double amount = Ledger::signedAmount(entry, cashFlow[i]);
+            int64_t month = DateUtility::monthOf(entry.date);
+            if (checkpoints.empty() || checkpoints.back().month != month)
+                checkpoints.push_back(CashFlowCheckpoint{month, running});
+            CashFlowCheckpoint& checkpoint = checkpoints.back();
+            checkpoint.count++;
+            if (entry.type == TransactionType::TOPUP) checkpoint.topup += amount;
+            else if (entry.type == TransactionType::WITHDRAW) checkpoint.withdraw -= amount;
+            else if (amount < 0) checkpoint.debit -= amount;
+            else checkpoint.credit += amount;
+            checkpoint.lastDate = std::max(checkpoint.lastDate, entry.date);
+            running += amount;
+        }
+
+        cashFlow.erase(cashFlow.begin(), cashFlow.begin() + cut);
+        cashFlow.shrink_to_fit();
+        // View tidak selalu urut posisi (kredit dari shard lain bisa datang belakangan), jadi dihitung ulang
+        oldestPosition = UINT64_MAX;
+        for (Ledger::Ref ref : cashFlow) oldestPosition = std::min(oldestPosition, Ledger::positionOf(ref));
+        return cut;
+    }
+
+    // Entri yang akan dibuang compactCashFlow(horizon), tanpa mengubah akun
+    std::vector<Transaction> getCashFlowBefore(time_t horizon) const {
+        std::lock_guard<std::mutex> lock(mtx);
+        std::vector<Transaction> entries;
+        for (size_t i = 0; i < cashFlow.size() && entryOf(cashFlow[i]).date < horizon; ++i)
+            entries.push_back(materialize(cashFlow[i]));
+        return entries;
+    }
+
+    std::vector<CashFlowCheckpoint> getCashFlowCheckpoints() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        return checkpoints;
+    }
+
+    // Pulihkan checkpoint bulanan (read replica)
+    void restoreCheckpoints(std::vector<CashFlowCheckpoint> restored) {
+        std::lock_guard<std::mutex> lock(mtx);
+        checkpoints = std::move(restored);
+    }
+
+    // Waktu aktivitas terakhir (termasuk entri yang sudah dipadatkan); 0 = belum pernah ada transaksi
+    time_t lastActivity() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        return lastActivityLocked();
     }
 
-    // Filter cash flow berdasarkan hari terakhir (credit/debit) 
+    // Filter cash flow berdasarkan hari terakhir (credit/debit). Entri yang lebih tua dari retensi
+    // sudah dipadatkan dan tidak ikut; retensi minimal Bank::MIN_CASH_FLOW_RETENTION_DAYS.
     std::vector<Transaction> getCashFlowSince(time_t threshold) const {
+        std::lock_guard<std::mutex> lock(mtx);
         std::vector<Transaction> filtered;
-        for (const auto& t : cashFlow) {
-            if (t.getDate() >= threshold) {
-                filtered.push_back(t);
+        for (Ledger::Ref ref : cashFlow) {
+            if (entryOf(ref).date >= threshold) {
+                filtered.push_back(materialize(ref));
             }
         }
         return filtered;
@@ -82,16 +313,18 @@ public:
 
     // Representasi untuk serialisasi (Id, OwnerId, Balance)
     std::string toString() const {
+        std::lock_guard<std::mutex> lock(mtx);
         return accountId + "," + ownerId + "," + std::to_string(balance);
     }
     
     // Metode Sederhana untuk cek Dormancy (tidak ada transaksi dalam sebulan) [cite: 24]
     bool isDormant() const {
-        if (cashFlow.empty()) return true; // Tidak pernah ada transaksi
+        time_t last = lastActivity();
+        if (last == 0) return true; // Tidak pernah ada transaksi
 
         time_t oneMonthAgo = DateUtility::getPastMonth();
-        // Cek apakah transaksi terakhir lebih lama dari sebulan
-        return cashFlow.back().getDate() < oneMonthAgo; 
+        // Cek apakah transaksi terakhir (termasuk yang sudah dipadatkan) lebih lama dari sebulan
+        return last < oneMonthAgo; 
     }
 };
 
@@ -3,26 +3,50 @@
 #ifndef BUYER_H
 #define BUYER_H
 
+#include <iterator>
 #include "User.h"
 
 class Buyer : public User {
 private:
-    std::vector<std::string> orderIds; // Hanya ID order untuk membatasi referensi objek
+    std::vector<Id> orderIds; // Hanya ID order untuk membatasi referensi objek
 
 public:
-    Buyer(const std::string& id, const std::string& user, const std::string& pass)
+    Buyer(const Id& id, const std::string& user, const std::string& pass)
         : User(id, user, pass) {}
         
-    void addOrderId(const std::string& orderId) {
+    void addOrderId(const Id& orderId) {
         orderIds.push_back(orderId);
+        markDirty();
     }
     
-    const std::vector<std::string>& getOrderIds() const {
+    // Pulihkan daftar order dari file (tanpa dirty tracking)
+    void restoreOrderIds(std::vector<Id>&& ids) {
+        orderIds = std::move(ids);
+    }
+
+    void restoreOrderId(const Id& orderId) {
+        orderIds.push_back(orderId);
+    }
+
+    // Tambahkan banyak order sekaligus (impor massal), satu kali alokasi
+    void appendOrderIds(std::vector<Id>&& ids) {
+        orderIds.insert(orderIds.end(), std::make_move_iterator(ids.begin()), std::make_move_iterator(ids.end()));
+    }
+
+    const std::vector<Id>& getOrderIds() const {
         return orderIds;
     }
 
     // Check spending the last k days [cite: 40] (Fitur ini akan diimplementasikan oleh Store)
     
+    std::shared_ptr<User> clone() const override {
+        return std::make_shared<Buyer>(*this);
+    }
+
+    size_t memoryBytes() const override {
+        return MemoryFootprint::shared<Buyer>() + stringHeapBytes() + MemoryFootprint::buffer(orderIds);
+    }
+
     // Implementasi toString untuk serialisasi
     std::string toString() const override {
         // Format: BUYER,ID,Username,Password,Order1_ID|Order2_ID|...
@@ -0,0 +1,185 @@
+// File: ChangeTracker.h
+
+#ifndef CHANGETRACKER_H
+#define CHANGETRACKER_H
+
+#include <array>
+#include <atomic>
+#include <set>
+#include <string>
+#include <mutex>
+#include <utility>
+#include "Id.h"
+
+// Mencatat record mana saja yang berubah sejak checkpoint terakhir (dirty tracking),
+// sehingga checkpoint inkremental hanya menulis record tersebut: biaya O(perubahan).
+// Server yang menerbitkan read replica mengaktifkan daftar kedua (replica) dengan cara yang sama, sehingga
+// penerbitan hanya menyalin record yang berubah sejak penerbitan sebelumnya.
+//
+// Daftar dibagi ke beberapa stripe menurut hash ID (item menurut SellerId), masing-masing dengan lock
+// sendiri, agar penandaan dari thread shard yang berbeda jarang saling menunggu. Pengambilan
+// (take/takeReplica) menggabungkan semua stripe.
+class ChangeTracker
+{
+public:
+    using ItemKey = std::pair<Id, Id>; // (SellerId, ItemId)
+
+    // Daftar perubahan yang diambil sekaligus (dipegang snapshot sampai penulisannya selesai)
+    struct Changes
+    {
+        std::set<Id> users;        // UserId (data user / daftar order)
+        std::set<ItemKey> items;   // Item milik seller (stok/registrasi)
+        std::set<Id> accounts;     // OwnerId akun bank (saldo)
+        std::set<Id> transactions; // TId transaksi toko (baru / ganti status)
+
+        void merge(Changes &other)
+        {
+            users.merge(other.users);
+            items.merge(other.items);
+            accounts.merge(other.accounts);
+            transactions.merge(other.transactions);
+        }
+
+        size_t size() const { return users.size() + items.size() + accounts.size() + transactions.size(); }
+    };
+
+private:
+    static constexpr size_t STRIPES = 16;
+
+    struct alignas(64) Stripe
+    {
+        mutable std::mutex mtx;
+        Changes dirty;   // Perubahan sejak checkpoint terakhir
+        Changes replica; // Perubahan sejak takeReplica terakhir
+    };
+
+    std::array<Stripe, STRIPES> stripes;
+    std::atomic<bool> replicaFeed{false};  // Daftar replica hanya diisi jika ada publisher
+    std::atomic<bool> replicaResync{true}; // Daftar replica tidak lengkap: salin ulang seluruh state
+
+    // Konsep Singleton
+    ChangeTracker() = default;
+    ChangeTracker(const ChangeTracker &) = delete;
+    ChangeTracker &operator=(const ChangeTracker &) = delete;
+
+    Stripe &stripeOf(const Id &id) { return stripes[id.hash() % STRIPES]; }
+
+    // Tandai key di daftar checkpoint (dan replica jika aktif) milik stripe-nya
+    template <typename Key>
+    void mark(const Id &stripeKey, const Key &key, std::set<Key> Changes::*member, bool replicaToo = true)
+    {
+        Stripe &stripe = stripeOf(stripeKey);
+        bool feed = replicaToo && replicaFeed.load(std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(stripe.mtx);
+        (stripe.dirty.*member).insert(key);
+        if (feed)
+            (stripe.replica.*member).insert(key);
+    }
+
+public:
+    static ChangeTracker &getInstance()
+    {
+        static ChangeTracker instance;
+        return instance;
+    }
+
+    void markUser(const Id &userId) { mark(userId, userId, &Changes::users); }
+
+    void markItem(const Id &sellerId, const Id &itemId) { mark(sellerId, ItemKey(sellerId, itemId), &Changes::items); }
+
+    void markAccount(const Id &ownerId) { mark(ownerId, ownerId, &Changes::accounts); }
+
+    void markTransaction(const Id &tId) { mark(tId, tId, &Changes::transactions); }
+
+    // Ambil dan kosongkan daftar perubahan (dipanggil saat checkpoint/snapshot)
+    void takeAll(std::set<Id> &users, std::set<ItemKey> &items,
+                 std::set<Id> &accounts, std::set<Id> &transactions)
+    {
+        Changes changes = take();
+        users.swap(changes.users);
+        items.swap(changes.items);
+        accounts.swap(changes.accounts);
+        transactions.swap(changes.transactions);
+    }
+
+    Changes take()
+    {
+        Changes changes;
+        for (Stripe &stripe : stripes)
+        {
+            std::lock_guard<std::mutex> lock(stripe.mtx);
+            changes.merge(stripe.dirty);
+            stripe.dirty = Changes();
+        }
+        return changes;
+    }
+
+    // Tandai ulang perubahan yang gagal ditulis (mis. snapshot background gagal) agar ikut checkpoint berikutnya
+    void restore(const Changes &changes)
+    {
+        for (const Id &id : changes.users)
+            mark(id, id, &Changes::users, false);
+        for (const ItemKey &key : changes.items)
+            mark(key.first, key, &Changes::items, false);
+        for (const Id &id : changes.accounts)
+            mark(id, id, &Changes::accounts, false);
+        for (const Id &id : changes.transactions)
+            mark(id, id, &Changes::transactions, false);
+    }
+
+    // Snapshot penuh mencakup semua perubahan, jadi daftar dirty bisa dibuang. State baru saja dimuat,
+    // sehingga replica harus disalin ulang penuh.
+    void clear()
+    {
+        for (Stripe &stripe : stripes)
+        {
+            std::lock_guard<std::mutex> lock(stripe.mtx);
+            stripe.dirty = Changes();
+        }
+        markAll();
+    }
+
+    // State diisi massal tanpa menandai record satu per satu (impor, generator)
+    void markAll()
+    {
+        replicaResync.store(true);
+        for (Stripe &stripe : stripes)
+        {
+            std::lock_guard<std::mutex> lock(stripe.mtx);
+            stripe.replica = Changes();
+        }
+    }
+
+    // Mulai mencatat daftar replica; penerbitan pertama selalu menyalin seluruh state
+    void enableReplicaFeed()
+    {
+        replicaResync.store(true);
+        replicaFeed.store(true);
+    }
+
+    // Ambil dan kosongkan daftar replica. false = daftar tidak lengkap, seluruh state harus disalin.
+    bool takeReplica(Changes &changes)
+    {
+        bool complete = !replicaResync.exchange(false);
+        for (Stripe &stripe : stripes)
+        {
+            std::lock_guard<std::mutex> lock(stripe.mtx);
+            changes.merge(stripe.replica);
+            stripe.replica = Changes();
+        }
+        return complete;
+    }
+
+    size_t pendingCount() const
+    {
+        size_t count = 0;
+        for (const Stripe &stripe : stripes)
+        {
+            std::lock_guard<std::mutex> lock(stripe.mtx);
+            count += stripe.dirty.size();
+        }
+        return count;
+    }
+};
+
+#endif // CHANGETRACKER_H
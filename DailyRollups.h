@@ -0,0 +1,188 @@
+// File: DailyRollups.h
+
+#ifndef DAILYROLLUPS_H
+#define DAILYROLLUPS_H
+
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include "Transaction.h"
+
+// Sumber data laporan berbasis waktu:
+//   EXACT       = scan transaksi mentah
+//   APPROXIMATE = sketch berukuran tetap (popularitas)
+//   ROLLUP      = agregat harian (hanya hari penuh, O(hari x key yang tersentuh))
+enum class AnalyticsMode
+{
+    EXACT,
+    APPROXIMATE,
+    ROLLUP
+};
+
+// Agregat transaksi toko (yang tidak dibatalkan): jumlah transaksi, unit, dan nilai
+struct RollupCell
+{
+    int64_t count = 0;
+    int64_t units = 0;
+    double amount = 0.0;
+
+    void apply(int sign, int quantity, double value)
+    {
+        count += sign;
+        units += sign * quantity;
+        amount += sign * value;
+    }
+};
+
+// Agregat cash flow satu akun (per OwnerId)
+struct AccountRollup
+{
+    int64_t count = 0;
+    double topup = 0.0;
+    double withdraw = 0.0;
+    double debit = 0.0;  // Pembayaran pembelian (disimpan positif)
+    double credit = 0.0; // Penerimaan dari penjualan / refund
+};
+
+struct SellerRollup
+{
+    RollupCell total;
+    std::unordered_map<Id, RollupCell> items;  // ItemId -> agregat
+    std::unordered_map<Id, RollupCell> buyers; // BuyerId -> agregat
+};
+
+struct DayRollup
+{
+    std::unordered_map<Id, RollupCell> items;       // ItemId (seluruh seller)
+    std::unordered_map<Id, RollupCell> buyers;      // BuyerId
+    std::unordered_map<Id, SellerRollup> sellers;   // SellerId
+    std::unordered_map<Id, AccountRollup> accounts; // OwnerId
+};
+
+// Tabel rollup harian (UTC) yang dipelihara inkremental: setiap pembelian/pembatalan dan setiap
+// entri cash flow langsung memperbarui hari yang bersangkutan. Disimpan bersama snapshot.
+class DailyRollups
+{
+public:
+    using Days = std::map<int64_t, DayRollup>; // Nomor hari (time / 86400) -> agregat
+
+private:
+    mutable std::mutex mtx;
+    Days days;
+    std::set<int64_t> changedDays; // Hari yang berubah sejak takeChanged terakhir (read replica)
+
+    // Dipanggil di bawah mtx
+    void touchAll()
+    {
+        for (const auto &pair : days)
+            changedDays.insert(pair.first);
+    }
+
+    // Konsep Singleton
+    DailyRollups() = default;
+    DailyRollups(const DailyRollups &) = delete;
+    DailyRollups &operator=(const DailyRollups &) = delete;
+
+public:
+    static DailyRollups &getInstance()
+    {
+        static DailyRollups instance;
+        return instance;
+    }
+
+    // Laporan mode ROLLUP membulatkan awal jendela ke awal hari dari 'since'
+    static int64_t dayOf(time_t t) { return static_cast<int64_t>(t) / 86400; }
+
+    // sign = +1 untuk transaksi baru, -1 saat transaksi dibatalkan
+    void applyPurchase(const Transaction &t, int sign)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        int64_t dayNumber = dayOf(t.getDate());
+        DayRollup &day = days[dayNumber];
+        changedDays.insert(dayNumber);
+        day.items[t.getItemId()].apply(sign, t.getQuantity(), t.getAmount());
+        day.buyers[t.getBuyerId()].apply(sign, t.getQuantity(), t.getAmount());
+        SellerRollup &seller = day.sellers[t.getSellerId()];
+        seller.total.apply(sign, t.getQuantity(), t.getAmount());
+        seller.items[t.getItemId()].apply(sign, t.getQuantity(), t.getAmount());
+        seller.buyers[t.getBuyerId()].apply(sign, t.getQuantity(), t.getAmount());
+    }
+
+    // amount dari sudut pandang pemilik akun (negatif = dana keluar)
+    void applyCashFlow(const Id &ownerId, time_t date, TransactionType type, double amount)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        int64_t dayNumber = dayOf(date);
+        AccountRollup &account = days[dayNumber].accounts[ownerId];
+        changedDays.insert(dayNumber);
+        account.count++;
+        if (type == TransactionType::TOPUP)
+            account.topup += amount;
+        else if (type == TransactionType::WITHDRAW)
+            account.withdraw -= amount; // Withdraw dicatat negatif di cash flow
+        else if (amount < 0)
+            account.debit -= amount;
+        else
+            account.credit += amount;
+    }
+
+    // Panggil fn(day, DayRollup) untuk setiap hari >= fromDay yang punya data (urut hari)
+    template <typename Fn>
+    void forEachDaySince(int64_t fromDay, Fn fn) const
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        for (auto it = days.lower_bound(fromDay); it != days.end(); ++it)
+            fn(it->first, it->second);
+    }
+
+    // Hapus agregat transaksi toko (agregat akun dipertahankan karena cash flow tidak disimpan ulang)
+    void clearPurchases()
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        touchAll();
+        for (auto &pair : days)
+        {
+            pair.second.items.clear();
+            pair.second.buyers.clear();
+            pair.second.sellers.clear();
+        }
+    }
+
+    // Salinan untuk snapshot (diambil di thread pemilik state)
+    Days copy() const
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        return days;
+    }
+
+    void replace(Days &&loaded)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        touchAll();
+        days = std::move(loaded);
+        touchAll();
+    }
+
+    // Salinan hari yang berubah sejak panggilan sebelumnya (read replica). 'touched' diisi nomor hari
+    // tersebut; hari yang tidak ada di hasil sudah dihapus.
+    Days takeChanged(std::set<int64_t> &touched)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        Days changed;
+        for (int64_t day : changedDays)
+        {
+            auto it = days.find(day);
+            if (it != days.end())
+                changed.emplace(*it);
+        }
+        touched.swap(changedDays);
+        changedDays.clear();
+        return changed;
+    }
+};
+
+#endif // DAILYROLLUPS_H
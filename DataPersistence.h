@@ -6,82 +6,1242 @@
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <cstdio>
+#include <future>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <string_view>
+#include <charconv>
+#include <initializer_list>
 #include "Store.h"
 #include "Bank.h"
+#include "Journal.h"
+#include "Snapshot.h"
+#include "ChangeTracker.h"
+#include "LedgerFormat.h"
+#include "MappedFile.h"
+#include "SharedSnapshot.h"
+#include "Metrics.h"
+#include "Parallel.h"
 
 class DataPersistence
 {
 private:
     static const std::string USER_FILE;
     static const std::string ACCOUNT_FILE;
-    static const std::string TRANSACTION_FILE;
+    static const std::string TRANSACTION_FILE; // Format teks lama (hanya dibaca untuk migrasi)
+    static const std::string LEDGER_FILE;      // Ledger biner kolumnar (lihat LedgerFormat.h)
+    static const std::string SNAPSHOT_META_FILE;
+    static const std::string CHECKPOINT_FILE;
+    static const std::string ROLLUP_FILE;      // Rollup harian (ditulis bersama snapshot)
+    static const std::string METRICS_FILE;
+    static const std::string MEMORY_FILE;
+    static const std::string CASHFLOW_ARCHIVE_FILE;
 
-    // Helper untuk memecah string (split)
-    static std::vector<std::string> split(const std::string &s, char delimiter)
+    static std::future<bool> pendingSnapshot; // Snapshot yang sedang ditulis di background
+
+    // Helper untuk memecah string tanpa alokasi: token berupa string_view ke buffer asli.
+    // maxParts > 0 membatasi jumlah token (token terakhir berisi sisa string).
+    static void split(std::string_view s, char delimiter, std::vector<std::string_view> &tokens, size_t maxParts = 0)
+    {
+        tokens.clear();
+        size_t start = 0;
+        while (maxParts == 0 || tokens.size() + 1 < maxParts)
+        {
+            size_t pos = s.find(delimiter, start);
+            if (pos == std::string_view::npos)
+                break;
+            tokens.push_back(s.substr(start, pos - start));
+            start = pos + 1;
+        }
+        tokens.push_back(s.substr(start));
+    }
+
+    template <typename T>
+    static bool parseNumber(std::string_view s, T &value)
+    {
+        auto res = std::from_chars(s.data(), s.data() + s.size(), value);
+        return res.ec == std::errc() && res.ptr == s.data() + s.size();
+    }
+
+    // --- Parser per baris (dipanggil paralel, tidak menyentuh Store/Bank) ---
+
+    // Item format: ID,Name,Price,Stock (nama boleh mengandung koma)
+    static bool parseItem(std::string_view s, std::vector<Item> &out)
+    {
+        size_t first = s.find(',');
+        size_t last = s.rfind(',');
+        if (first == std::string_view::npos || last == first)
+            return false;
+        size_t priceStart = s.rfind(',', last - 1);
+        if (priceStart < first)
+            return false;
+
+        double price = 0.0;
+        int stock = 0;
+        if (!parseNumber(s.substr(priceStart + 1, last - priceStart - 1), price) || !parseNumber(s.substr(last + 1), stock))
+            return false;
+        std::string_view name = priceStart > first ? s.substr(first + 1, priceStart - first - 1) : std::string_view();
+        out.emplace_back(Id(s.substr(0, first)), std::string(name), price, stock);
+        return true;
+    }
+
+    // BUYER,ID,Username,Password,Order1|Order2   atau   SELLER,ID,Username,Password,Order1|...|Item1;Item2
+    static UserPtr parseUser(std::string_view line, std::vector<std::string_view> &fields)
+    {
+        split(line, ',', fields, 5);
+        if (fields.size() < 5 || (fields[0] != "BUYER" && fields[0] != "SELLER"))
+            return nullptr;
+
+        bool isSeller = fields[0] == "SELLER";
+        std::string_view orders = fields[4];
+        std::string_view itemList;
+        if (isSeller)
+        {
+            size_t bar = orders.rfind('|');
+            if (bar == std::string_view::npos)
+                return nullptr;
+            itemList = orders.substr(bar + 1);
+            orders = orders.substr(0, bar);
+        }
+
+        Id id(fields[1]);
+        std::string username(fields[2]), password(fields[3]);
+        std::shared_ptr<Buyer> user;
+        if (isSeller)
+            user = std::make_shared<Seller>(id, username, password);
+        else
+            user = std::make_shared<Buyer>(id, username, password);
+
+        std::vector<Id> orderIds;
+        if (!orders.empty())
+        {
+            split(orders, '|', fields);
+            orderIds.reserve(fields.size());
+            for (std::string_view o : fields)
+                orderIds.emplace_back(o);
+        }
+        user->restoreOrderIds(std::move(orderIds));
+
+        if (isSeller && !itemList.empty())
+        {
+            auto seller = std::static_pointer_cast<Seller>(user);
+            std::vector<Item> items;
+            split(itemList, ';', fields);
+            for (std::string_view itemStr : fields)
+                parseItem(itemStr, items);
+            for (const Item &item : items)
+                seller->restoreItem(item);
+        }
+        return user;
+    }
+
+    static void parseUserRecord(std::string_view line, std::vector<std::string_view> &fields, std::vector<UserPtr> &out)
+    {
+        if (UserPtr user = parseUser(line, fields))
+            out.push_back(std::move(user));
+    }
+
+    // AccountId,OwnerId,Balance
+    static void parseAccount(std::string_view line, std::vector<std::string_view> &fields, std::vector<AccountRecord> &out)
+    {
+        split(line, ',', fields);
+        double balance = 0.0;
+        if (fields.size() == 3 && parseNumber(fields[2], balance))
+            out.push_back({Id(fields[0]), Id(fields[1]), balance});
+    }
+
+    // ID,ItemID,BuyerID,SellerID,Amount,Quantity,Date(time_t),Status(int),Type(int)
+    static void parseTransaction(std::string_view line, std::vector<std::string_view> &fields, std::vector<Transaction> &out)
+    {
+        split(line, ',', fields);
+        double amount = 0.0;
+        int quantity = 0, status = 0, type = 0;
+        long long date = 0;
+        if (fields.size() != 9 || !parseNumber(fields[4], amount) || !parseNumber(fields[5], quantity) ||
+            !parseNumber(fields[6], date) || !parseNumber(fields[7], status) || !parseNumber(fields[8], type))
+            return;
+        out.emplace_back(Id(fields[0]), Id(fields[1]), Id(fields[2]), Id(fields[3]),
+                         amount, quantity, static_cast<time_t>(date),
+                         static_cast<TransactionStatus>(status), static_cast<TransactionType>(type));
+    }
+
+    // Checkpoint cash flow (snapshot replica): OwnerId|month|opening|count|topup|withdraw|debit|credit|lastDate
+    static void parseCashFlowCheckpoint(std::string_view line, std::vector<std::string_view> &fields,
+                                        std::vector<std::pair<Id, CashFlowCheckpoint>> &out)
+    {
+        split(line, '|', fields);
+        CashFlowCheckpoint checkpoint{};
+        long long lastDate = 0;
+        if (fields.size() == 9 && parseNumber(fields[1], checkpoint.month) && parseNumber(fields[2], checkpoint.openingBalance) &&
+            parseNumber(fields[3], checkpoint.count) && parseNumber(fields[4], checkpoint.topup) &&
+            parseNumber(fields[5], checkpoint.withdraw) && parseNumber(fields[6], checkpoint.debit) &&
+            parseNumber(fields[7], checkpoint.credit) && parseNumber(fields[8], lastDate))
+        {
+            checkpoint.lastDate = static_cast<time_t>(lastDate);
+            out.emplace_back(Id(fields[0]), checkpoint);
+        }
+    }
+
+    // Status/tipe pada file impor boleh berupa angka (format transactions.dat) atau nama enum
+    static bool parseEnumField(std::string_view s, std::initializer_list<std::string_view> names, int &value)
     {
-        std::vector<std::string> tokens;
-        std::string token;
-        std::istringstream tokenStream(s);
-        while (std::getline(tokenStream, token, delimiter))
+        if (parseNumber(s, value))
+            return value >= 0 && value < static_cast<int>(names.size());
+        value = 0;
+        for (std::string_view name : names)
         {
-            tokens.push_back(token);
+            if (name == s)
+                return true;
+            value++;
         }
-        return tokens;
+        return false;
+    }
+
+    // Baris impor: ID,ItemID,BuyerID,SellerID,Amount,Quantity,Date(time_t),Status,Type
+    // Baris yang tidak valid (mis. header kolom atau ID lebih panjang dari Id::CAPACITY) dilewati.
+    static void parseImportRecord(std::string_view line, std::vector<std::string_view> &fields, std::vector<Transaction> &out)
+    {
+        split(line, ',', fields);
+        double amount = 0.0;
+        int quantity = 0, status = 0, type = 0;
+        long long date = 0;
+        if (fields.size() != 9 || !parseNumber(fields[4], amount) || !parseNumber(fields[5], quantity) ||
+            !parseNumber(fields[6], date) ||
+            !parseEnumField(fields[7], {"PAID", "COMPLETED", "CANCELLED"}, status) ||
+            !parseEnumField(fields[8], {"PURCHASE", "TOPUP", "WITHDRAW"}, type) ||
+            !std::all_of(fields.begin(), fields.begin() + 4, Id::fits))
+            return;
+        out.emplace_back(Id(fields[0]), Id(fields[1]), Id(fields[2]), Id(fields[3]),
+                         amount, quantity, static_cast<time_t>(date),
+                         static_cast<TransactionStatus>(status), static_cast<TransactionType>(type));
+    }
+
+    // File rollup, satu record per baris; record setelah "D|hari" milik hari tersebut:
+    //   I|ItemId|count|units|amount   B|BuyerId|...   S|SellerId|...
+    //   SI|SellerId|ItemId|...        SB|SellerId|BuyerId|...
+    //   A|OwnerId|count|topup|withdraw|debit|credit
+    static bool parseRollupCell(const std::vector<std::string_view> &fields, size_t first, RollupCell &cell)
+    {
+        return fields.size() == first + 3 && parseNumber(fields[first], cell.count) &&
+               parseNumber(fields[first + 1], cell.units) && parseNumber(fields[first + 2], cell.amount);
+    }
+
+    static void parseRollups(std::string_view data, DailyRollups::Days &days)
+    {
+        std::vector<std::string_view> fields;
+        DayRollup *day = nullptr;
+        size_t pos = 0;
+        while (pos < data.size())
+        {
+            size_t newline = data.find('\n', pos);
+            std::string_view line = data.substr(pos, newline == std::string_view::npos ? std::string_view::npos : newline - pos);
+            pos = newline == std::string_view::npos ? data.size() : newline + 1;
+            split(line, '|', fields);
+            std::string_view kind = fields[0];
+            RollupCell cell;
+            if (kind == "D")
+            {
+                int64_t dayId = 0;
+                day = fields.size() == 2 && parseNumber(fields[1], dayId) ? &days[dayId] : nullptr;
+            }
+            else if (!day)
+            {
+                continue; // Record tanpa blok hari yang valid
+            }
+            else if (kind == "I" && parseRollupCell(fields, 2, cell))
+                day->items[std::string(fields[1])] = cell;
+            else if (kind == "B" && parseRollupCell(fields, 2, cell))
+                day->buyers[std::string(fields[1])] = cell;
+            else if (kind == "S" && parseRollupCell(fields, 2, cell))
+                day->sellers[std::string(fields[1])].total = cell;
+            else if (kind == "SI" && parseRollupCell(fields, 3, cell))
+                day->sellers[std::string(fields[1])].items[std::string(fields[2])] = cell;
+            else if (kind == "SB" && parseRollupCell(fields, 3, cell))
+                day->sellers[std::string(fields[1])].buyers[std::string(fields[2])] = cell;
+            else if (kind == "A" && fields.size() == 7)
+            {
+                AccountRollup account;
+                if (parseNumber(fields[2], account.count) && parseNumber(fields[3], account.topup) &&
+                    parseNumber(fields[4], account.withdraw) && parseNumber(fields[5], account.debit) &&
+                    parseNumber(fields[6], account.credit))
+                    day->accounts[std::string(fields[1])] = account;
+            }
+        }
+    }
+
+    static void writeRollupCell(std::ostream &out, const RollupCell &cell)
+    {
+        out << "|" << cell.count << "|" << cell.units << "|" << cell.amount << "\n";
+    }
+
+    static void writeRollups(std::ostream &out, const DailyRollups::Days &days)
+    {
+        out.precision(17); // Nilai uang harus terbaca ulang persis sama
+        for (const auto &dayPair : days)
+        {
+            const DayRollup &day = dayPair.second;
+            out << "D|" << dayPair.first << "\n";
+            for (const auto &pair : day.items)
+            {
+                out << "I|" << pair.first;
+                writeRollupCell(out, pair.second);
+            }
+            for (const auto &pair : day.buyers)
+            {
+                out << "B|" << pair.first;
+                writeRollupCell(out, pair.second);
+            }
+            for (const auto &seller : day.sellers)
+            {
+                out << "S|" << seller.first;
+                writeRollupCell(out, seller.second.total);
+                for (const auto &pair : seller.second.items)
+                {
+                    out << "SI|" << seller.first << "|" << pair.first;
+                    writeRollupCell(out, pair.second);
+                }
+                for (const auto &pair : seller.second.buyers)
+                {
+                    out << "SB|" << seller.first << "|" << pair.first;
+                    writeRollupCell(out, pair.second);
+                }
+            }
+            for (const auto &pair : day.accounts)
+            {
+                const AccountRollup &a = pair.second;
+                out << "A|" << pair.first << "|" << a.count << "|" << a.topup << "|" << a.withdraw
+                    << "|" << a.debit << "|" << a.credit << "\n";
+            }
+        }
+    }
+
+    // --- Eksekusi Paralel ---
+
+    // Pecah data menjadi potongan yang selaras dengan akhir baris, parse tiap potongan di thread terpisah.
+    // Hasil dikembalikan per potongan dengan urutan sesuai file.
+    template <typename T, typename ParseLine>
+    static std::vector<std::vector<T>> parseLinesParallel(std::string_view data, ParseLine parseLine)
+    {
+        const size_t MIN_CHUNK = 1 << 20; // Potongan kecil tidak sebanding dengan biaya thread
+        size_t chunkCount = std::max<size_t>(1, std::min<size_t>(data.size() / MIN_CHUNK,
+                                                                 4 * Parallel::workerCount()));
+        std::vector<std::string_view> chunks;
+        size_t begin = 0;
+        for (size_t c = 1; c <= chunkCount && begin < data.size(); ++c)
+        {
+            size_t end = std::max(begin, data.size() * c / chunkCount);
+            size_t newline = data.find('\n', end);
+            end = (c == chunkCount || newline == std::string_view::npos) ? data.size() : newline + 1;
+            chunks.push_back(data.substr(begin, end - begin));
+            begin = end;
+        }
+
+        std::vector<std::vector<T>> results(chunks.size());
+        Parallel::run(chunks.size(), [&](size_t c)
+                    {
+            std::vector<std::string_view> fields; // Buffer token dipakai ulang per thread
+            std::string_view chunk = chunks[c];
+            size_t pos = 0;
+            while (pos < chunk.size())
+            {
+                size_t newline = chunk.find('\n', pos);
+                if (newline == std::string_view::npos)
+                    newline = chunk.size();
+                std::string_view line = chunk.substr(pos, newline - pos);
+                if (!line.empty() && line.back() == '\r')
+                    line.remove_suffix(1);
+                if (!line.empty())
+                    parseLine(line, fields, results[c]);
+                pos = newline + 1;
+            } });
+        return results;
+    }
+
+    // Decode ledger biner: header blok dibaca berurutan (murah), payload blok di-decode paralel.
+    // Blok rusak dan ekor yang terpotong dilewati, lalu dilaporkan ke konsol dan metrics dengan nama 'source'.
+    static std::vector<std::vector<Transaction>> loadLedgerParallel(std::string_view data, const std::string &source)
+    {
+        static Metrics::Counter &badBlocks = Metrics::getInstance().counter("persistence_ledger_bad_blocks_total", "Jumlah blok ledger biner yang rusak atau terpotong saat dibaca");
+        if (data.empty())
+            return {};
+        if (data.size() < 4 || data.substr(0, 4) != "LDG1")
+        {
+            badBlocks.increment();
+            std::cout << "Error: " << source << " bukan ledger LDG1, seluruh isinya dilewati." << std::endl;
+            return {};
+        }
+
+        std::vector<std::pair<LedgerFormat::BlockHeader, const uint8_t *>> blocks;
+        size_t pos = 4;
+        bool truncated = false;
+        while (pos < data.size())
+        {
+            const uint8_t *p = reinterpret_cast<const uint8_t *>(data.data() + pos);
+            if (pos + LedgerFormat::BLOCK_HEADER_SIZE > data.size())
+            {
+                truncated = true; // Header blok terakhir terpotong
+                break;
+            }
+            LedgerFormat::BlockHeader header = LedgerFormat::decodeHeader(p);
+            pos += LedgerFormat::BLOCK_HEADER_SIZE;
+            if (pos + header.payloadSize > data.size())
+            {
+                truncated = true; // Payload blok terakhir terpotong
+                break;
+            }
+            blocks.emplace_back(header, p + LedgerFormat::BLOCK_HEADER_SIZE);
+            pos += header.payloadSize;
+        }
+
+        std::vector<std::vector<Transaction>> results(blocks.size());
+        std::vector<char> damaged(blocks.size(), 0);
+        Parallel::run(blocks.size(), [&](size_t b)
+                    {
+            if (!LedgerFormat::decodeBlock(blocks[b].first, blocks[b].second, results[b]))
+            {
+                results[b].clear();
+                damaged[b] = 1;
+            } });
+
+        size_t bad = static_cast<size_t>(std::count(damaged.begin(), damaged.end(), 1));
+        if (bad > 0 || truncated)
+        {
+            size_t skipped = bad + (truncated ? 1 : 0);
+            badBlocks.increment(skipped);
+            std::cout << "Error: " << source << ": " << skipped << " blok ledger dilewati (" << bad << " rusak"
+                      << (truncated ? ", 1 terpotong" : "") << "). Sebagian transaksi tidak dimuat." << std::endl;
+        }
+        return results;
+    }
+
+    // --- Penggabungan hasil parse ke Store & Bank (berurutan, satu-satunya bagian yang menyentuh state) ---
+
+    static size_t restoreUsers(const std::vector<std::vector<UserPtr>> &userChunks)
+    {
+        size_t count = 0;
+        for (const auto &chunk : userChunks)
+        {
+            for (const UserPtr &user : chunk)
+            {
+                Store::getInstance().restoreUser(user);
+                count++;
+            }
+        }
+        return count;
+    }
+
+    static void restoreBalances(const std::vector<std::vector<AccountRecord>> &accountChunks)
+    {
+        for (const auto &chunk : accountChunks)
+        {
+            for (const AccountRecord &record : chunk)
+            {
+                if (BankAccountPtr account = Bank::getInstance().getAccount(record.ownerId))
+                    account->restoreBalance(record.balance);
+            }
+        }
+    }
+
+    static size_t restoreTransactions(std::vector<std::vector<Transaction>> &transactionChunks)
+    {
+        size_t count = 0;
+        for (auto &chunk : transactionChunks)
+        {
+            for (Transaction &t : chunk)
+            {
+                Store::getInstance().restoreTransaction(std::move(t));
+                count++;
+            }
+        }
+        return count;
+    }
+
+    // Terapkan batch log checkpoint yang lebih baru dari snapshot. Mengembalikan posisi journal terakhir.
+    static uint64_t applyCheckpointLog(uint64_t covered)
+    {
+        MappedFile file(CHECKPOINT_FILE);
+        if (!file.isOpen())
+            return covered;
+
+        Store &store = Store::getInstance();
+        std::vector<std::string_view> batch, fields, record;
+        std::string_view data = file.view();
+        size_t pos = 0;
+        while (pos < data.size())
+        {
+            size_t newline = data.find('\n', pos);
+            if (newline == std::string_view::npos)
+                break; // Baris terakhir belum lengkap
+            std::string_view line = data.substr(pos, newline - pos);
+            pos = newline + 1;
+            if (line.substr(0, 2) != "J|")
+            {
+                if (!line.empty())
+                    batch.push_back(line);
+                continue;
+            }
+
+            split(line, '|', fields);
+            uint64_t position = 0;
+            if (fields.size() < 3 || !parseNumber(fields[2], position) || position <= covered)
+            {
+                batch.clear(); // Batch sudah tercakup snapshot
+                continue;
+            }
+
+            // Urutan penerapan: User dulu (agar seller ada), lalu Item, Akun, Transaksi
+            std::stable_sort(batch.begin(), batch.end(), [](std::string_view a, std::string_view b)
+                             {
+                auto rank = [](char kind) { return kind == 'U' ? 0 : kind == 'I' ? 1 : kind == 'A' ? 2 : 3; };
+                return rank(a[0]) < rank(b[0]); });
+            for (std::string_view entry : batch)
+            {
+                split(entry, '|', record, 4);
+                if (record.size() < 4)
+                    continue;
+                std::string_view payload = record[3];
+                if (record[0] == "U")
+                {
+                    UserPtr user = parseUser(payload, fields);
+                    if (!user)
+                        continue;
+                    auto existing = store.getUsers().find(user->getId());
+                    auto newSeller = std::dynamic_pointer_cast<Seller>(user);
+                    if (existing != store.getUsers().end() && newSeller)
+                    {
+                        if (auto oldSeller = std::dynamic_pointer_cast<Seller>(existing->second))
+                            newSeller->takeItemsFrom(*oldSeller); // Record U seller tidak membawa item
+                    }
+                    store.restoreUser(user);
+                }
+                else if (record[0] == "I")
+                {
+                    size_t slash = record[1].find('/');
+                    auto it = store.getUsers().find(std::string(record[1].substr(0, slash)));
+                    SellerPtr seller = it == store.getUsers().end() ? nullptr : std::dynamic_pointer_cast<Seller>(it->second);
+                    std::vector<Item> items;
+                    if (seller && parseItem(payload, items))
+                        store.restoreItem(seller, items.front());
+                }
+                else if (record[0] == "A")
+                {
+                    std::vector<AccountRecord> accounts;
+                    parseAccount(payload, fields, accounts);
+                    if (!accounts.empty())
+                    {
+                        if (BankAccountPtr account = Bank::getInstance().getAccount(accounts.front().ownerId))
+                            account->restoreBalance(accounts.front().balance);
+                    }
+                }
+                else if (record[0] == "T")
+                {
+                    std::vector<Transaction> transactions;
+                    parseTransaction(payload, fields, transactions);
+                    if (!transactions.empty())
+                        store.replayTransaction(transactions.front());
+                }
+            }
+            batch.clear();
+            covered = position;
+        }
+        return covered;
     }
 
 public:
     // --- Load Data ---
+    // File dipetakan ke memori lalu di-parse paralel di semua core; hasil per thread digabung ke Store/Bank.
     static void loadData()
     {
         std::cout << "Loading data..." << std::endl;
-        // Kita tidak akan memuat semua secara lengkap karena kerumitan C++ Serialization/Deserialization.
-        // Cukup memuat data yang paling penting (User dan Transaction)
 
-        // 1. Load Users & Accounts (Simulasi Deserialisasi)
-        // Note: Implementasi ini akan sangat rumit karena C++ tidak otomatis. Kita fokus pada kerangka.
+        // 1. Parse Users, Accounts dan Transactions secara paralel (belum menyentuh Store/Bank)
+        std::vector<std::vector<UserPtr>> userChunks;
+        std::vector<std::vector<AccountRecord>> accountChunks;
+        std::vector<std::vector<Transaction>> transactionChunks;
+        {
+            MappedFile userFile(USER_FILE);
+            MappedFile accountFile(ACCOUNT_FILE);
+            MappedFile ledgerFile(LEDGER_FILE);
+
+            userChunks = parseLinesParallel<UserPtr>(userFile.view(), parseUserRecord);
+            accountChunks = parseLinesParallel<AccountRecord>(accountFile.view(), parseAccount);
+
+            if (ledgerFile.isOpen())
+            {
+                transactionChunks = loadLedgerParallel(ledgerFile.view(), LEDGER_FILE);
+            }
+            else
+            {
+                // Migrasi: belum ada ledger biner, baca format teks lama
+                MappedFile transactionFile(TRANSACTION_FILE);
+                transactionChunks = parseLinesParallel<Transaction>(transactionFile.view(), parseTransaction);
+            }
+        }
+
+        // 2. Gabungkan hasil ke Store & Bank
+        Store &store = Store::getInstance();
+        size_t userCount = restoreUsers(userChunks);
+        restoreBalances(accountChunks);
+        size_t transactionCount = restoreTransactions(transactionChunks);
 
-        // 2. Load Transactions (Jika sudah ada file, diabaikan untuk fokus pada struktur OOP)
+        // 3. Rollup harian sesuai snapshot; data lama tanpa file rollup dibangun ulang dari ledger
+        //    (agregat akun tidak bisa dibangun ulang karena cash flow tidak disimpan)
+        {
+            MappedFile rollupFile(ROLLUP_FILE);
+            DailyRollups::Days days;
+            if (rollupFile.isOpen())
+                parseRollups(rollupFile.view(), days);
+            DailyRollups::getInstance().replace(std::move(days));
+            if (!rollupFile.isOpen())
+                store.rebuildRollups();
+        }
 
-        std::cout << "Data loaded (simulated)." << std::endl;
+        // 4. Terapkan perubahan dari log checkpoint yang belum tercakup snapshot
+        uint64_t position = applyCheckpointLog(readSnapshotJournal());
+        store.rebuildSketches();
+        Journal::getInstance().setPosition(position);
+        ChangeTracker::getInstance().clear(); // State di memori sekarang sama dengan di disk
+
+        std::cout << "Data loaded: " << userCount << " users, " << transactionCount
+                  << " store transactions (journal " << position << ")." << std::endl;
     }
 
-    // --- Save Data ---
-    static void saveData()
+    // --- Impor Histori ---
+    struct ImportResult
     {
-        std::cout << "Saving data (Serialization)..." << std::endl;
+        size_t storeTransactions = 0; // Transaksi toko baru
+        size_t bankTransactions = 0;  // Pergerakan dana yang diterapkan
+        size_t rejected = 0;          // Transaksi toko dengan ID yang sudah ada, atau pergerakan dana tanpa
+                                      // akun tujuan / dengan tanda jumlah yang salah
+    };
+
+    // Impor transaksi historis beserta waktu & status aslinya, dari CSV (kolom seperti transactions.dat,
+    // status/tipe boleh ditulis sebagai nama) atau ledger biner LDG1. Record dengan ItemID "N/A" adalah
+    // pergerakan dana bank milik BuyerID, selainnya transaksi toko.
+    // File di-parse paralel; Store & Bank masing-masing diisi satu kali dan index dibangun di akhir.
+    static bool importHistory(const std::string &path, ImportResult &result)
+    {
+        static Metrics::Histogram &latency = Metrics::getInstance().histogram("persistence_import_seconds", "Latensi impor histori massal");
+        Metrics::ScopedTimer timer(latency);
+
+        std::vector<std::vector<Transaction>> chunks;
+        {
+            MappedFile file(path);
+            if (!file.isOpen())
+                return false;
+            std::string_view data = file.view();
+            if (data.substr(0, 4) == "LDG1")
+                chunks = loadLedgerParallel(data, path);
+            else
+                chunks = parseLinesParallel<Transaction>(data, parseImportRecord);
+        }
+
+        size_t storeCount = 0, bankCount = 0;
+        for (const auto &chunk : chunks)
+        {
+            for (const Transaction &t : chunk)
+                (t.getItemId() == "N/A" ? bankCount : storeCount)++;
+        }
+
+        std::vector<Transaction> storeBatch, bankBatch;
+        storeBatch.reserve(storeCount);
+        bankBatch.reserve(bankCount);
+        for (auto &chunk : chunks)
+        {
+            for (Transaction &t : chunk)
+                (t.getItemId() == "N/A" ? bankBatch : storeBatch).push_back(std::move(t));
+            std::vector<Transaction>().swap(chunk); // Lepas memori per potongan lebih awal
+        }
+
+        result.storeTransactions = Store::getInstance().importTransactions(std::move(storeBatch));
+        result.bankTransactions = Bank::getInstance().importTransactions(std::move(bankBatch));
+        result.rejected = (storeCount - result.storeTransactions) + (bankCount - result.bankTransactions);
+        ChangeTracker::getInstance().markAll(); // Impor tidak menandai record satu per satu
+        return true;
+    }
+
+    // --- Snapshot ---
+
+    // Ambil salinan konsisten state Store & Bank. Harus dipanggil dari thread yang memiliki state
+    // (thread menu); hanya menyalin nilai sehingga jauh lebih cepat dari serialisasi + I/O.
+    // Daftar dirty dipindah ke snapshot; pemanggil mengembalikannya ke ChangeTracker jika penulisan gagal.
+    static std::shared_ptr<StoreSnapshot> captureSnapshot()
+    {
+        auto snapshot = std::make_shared<StoreSnapshot>();
+        snapshot->changes = ChangeTracker::getInstance().take(); // Semua perubahan sampai posisi ini tercakup snapshot
+        copyState(*snapshot);
+        return snapshot;
+    }
+
+    // Salin nilai state Store & Bank ke snapshot (tanpa menyentuh ChangeTracker)
+    static void copyState(StoreSnapshot &snapshot)
+    {
+        snapshot.journalPosition = Journal::getInstance().getPosition();
+        snapshot.takenAt = DateUtility::getCurrentTime();
+
+        const auto &users = Store::getInstance().getUsers();
+        snapshot.users.reserve(users.size());
+        for (const auto &pair : users)
+        {
+            snapshot.users.push_back(pair.second->clone());
+        }
+
+        const auto &accounts = Bank::getInstance().getAccounts();
+        snapshot.accounts.reserve(accounts.size());
+        for (const auto &pair : accounts)
+        {
+            snapshot.accounts.push_back({pair.second->getId(), pair.second->getOwnerId(), pair.second->getBalance()});
+        }
+
+        const auto &transactions = Store::getInstance().getStoreTransactions();
+        snapshot.transactions.reserve(transactions.size());
+        for (const auto &pair : transactions)
+        {
+            snapshot.transactions.push_back(pair.second);
+        }
+        snapshot.rollups = DailyRollups::getInstance().copy();
+    }
+
+    // Tulis snapshot ke file sementara lalu rename, sehingga file lama tetap utuh jika penyimpanan gagal.
+    // Tidak menyentuh Store/Bank, aman dijalankan di thread background.
+    static bool writeSnapshot(const StoreSnapshot &snapshot)
+    {
+        static Metrics::Histogram &latency = Metrics::getInstance().histogram("persistence_write_snapshot_seconds", "Latensi serialisasi + tulis snapshot");
+        Metrics::ScopedTimer timer(latency);
+
+        std::ofstream userFile(USER_FILE + ".tmp");
+        std::ofstream accountFile(ACCOUNT_FILE + ".tmp");
+        std::ofstream rollupFile(ROLLUP_FILE + ".tmp");
+        std::ofstream metaFile(SNAPSHOT_META_FILE + ".tmp");
+        if (!userFile.is_open() || !accountFile.is_open() || !rollupFile.is_open() || !metaFile.is_open())
+        {
+            return false;
+        }
 
         // Simpan Data User (Buyer/Seller) dan Item
-        std::ofstream userFile(USER_FILE);
-        if (userFile.is_open())
+        for (const auto &user : snapshot.users)
         {
-            for (const auto &pair : Store::getInstance().getUsers())
-            {
-                userFile << pair.second->toString() << "\n";
-            }
-            userFile.close();
-            std::cout << "Users & Items saved." << std::endl;
+            userFile << user->toString() << "\n";
         }
 
         // Simpan Data Bank Account (ID, OwnerID, Balance)
         // Note: Transaksi Bank Account disimpan dalam User CashFlow (tidak diserialisasi di sini)
-        // Ini adalah trade-off untuk menjaga fokus pada OOP structure.
+        for (const auto &account : snapshot.accounts)
+        {
+            accountFile << account.toString() << "\n";
+        }
+
+        // Simpan Data Store Transactions dalam ledger biner
+        std::vector<const Transaction *> records;
+        records.reserve(snapshot.transactions.size());
+        for (const auto &t : snapshot.transactions)
+        {
+            records.push_back(&t);
+        }
+        if (!LedgerFormat::writeFile(LEDGER_FILE + ".tmp", std::move(records)))
+        {
+            return false;
+        }
+
+        // Simpan rollup harian pada posisi journal yang sama
+        writeRollups(rollupFile, snapshot.rollups);
+
+        // Metadata: posisi journal yang tercakup oleh snapshot ini
+        metaFile << "journal=" << snapshot.journalPosition << "\n"
+                 << "time=" << snapshot.takenAt << "\n"
+                 << "users=" << snapshot.users.size() << "\n"
+                 << "accounts=" << snapshot.accounts.size() << "\n"
+                 << "transactions=" << snapshot.transactions.size() << "\n";
+
+        userFile.close();
+        accountFile.close();
+        rollupFile.close();
+        metaFile.close();
+        if (userFile.fail() || accountFile.fail() || rollupFile.fail() || metaFile.fail())
+        {
+            return false;
+        }
+
+        // Meta di-rename terakhir: jika ada, semua file data sudah lengkap
+        return std::rename((USER_FILE + ".tmp").c_str(), USER_FILE.c_str()) == 0 &&
+               std::rename((ACCOUNT_FILE + ".tmp").c_str(), ACCOUNT_FILE.c_str()) == 0 &&
+               std::rename((LEDGER_FILE + ".tmp").c_str(), LEDGER_FILE.c_str()) == 0 &&
+               std::rename((ROLLUP_FILE + ".tmp").c_str(), ROLLUP_FILE.c_str()) == 0 &&
+               std::rename((SNAPSHOT_META_FILE + ".tmp").c_str(), SNAPSHOT_META_FILE.c_str()) == 0;
+    }
+
+    // Apakah snapshot background masih berjalan
+    static bool isSnapshotRunning()
+    {
+        return pendingSnapshot.valid() &&
+               pendingSnapshot.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+    }
+
+    // Tunggu snapshot background selesai, mengembalikan hasilnya (true jika tidak ada snapshot tertunda)
+    static bool waitForSnapshot()
+    {
+        if (!pendingSnapshot.valid())
+            return true;
+        return pendingSnapshot.get();
+    }
+
+    // Seperti waitForSnapshot, tetapi kegagalan snapshot background dilaporkan ke konsol dan metrics
+    static bool collectSnapshot()
+    {
+        static Metrics::Counter &failed = Metrics::getInstance().counter("persistence_snapshot_failures_total", "Jumlah snapshot background yang gagal ditulis");
+        if (waitForSnapshot())
+            return true;
+        failed.increment();
+        std::cout << "Error: Snapshot background sebelumnya gagal ditulis." << std::endl;
+        return false;
+    }
+
+    // --- Save Data (Background) ---
+    // Ambil snapshot sekarang, tulis ke disk di thread lain. Mengembalikan posisi journal yang tercakup.
+    static bool saveDataAsync(uint64_t &journalPosition)
+    {
+        if (isSnapshotRunning())
+        {
+            return false; // Hanya satu snapshot dalam satu waktu
+        }
+        collectSnapshot(); // Ambil (dan laporkan) hasil snapshot sebelumnya
+
+        compactCashFlow();
+        std::shared_ptr<StoreSnapshot> snapshot = captureSnapshot();
+        journalPosition = snapshot->journalPosition;
+        pendingSnapshot = std::async(std::launch::async, [snapshot]()
+                                     {
+                                         if (writeSnapshot(*snapshot))
+                                             return true;
+                                         ChangeTracker::getInstance().restore(snapshot->changes); // Tetap ikut checkpoint inkremental
+                                         return false; });
+        return true;
+    }
+
+    // --- Checkpoint Inkremental ---
+    // Log checkpoint berisi record berkunci: Jenis|Kunci|Versi|Data
+    //   U = data user (seller tanpa item), I = item (SellerId/ItemId), A = akun bank, T = transaksi toko
+    //   J = penanda akhir batch, berisi posisi journal yang tercakup batch tersebut
+    // Record dengan kunci yang sama ditimpa oleh record yang muncul belakangan.
+
+    // Posisi journal yang tercakup snapshot penuh terakhir (0 jika belum ada)
+    static uint64_t readSnapshotJournal()
+    {
+        std::ifstream metaFile(SNAPSHOT_META_FILE);
+        std::string line;
+        while (std::getline(metaFile, line))
+        {
+            if (line.rfind("journal=", 0) == 0)
+            {
+                return std::stoull(line.substr(8));
+            }
+        }
+        return 0;
+    }
+
+    // --- Retensi Cash Flow ---
+    // Padatkan cash flow yang melewati masa retensi (lihat Bank::setCashFlowRetention). Dipanggil di awal
+    // setiap checkpoint/snapshot. Jika arsip aktif, entri yang dibuang ditambahkan ke cashflow_archive.log
+    // dengan format OwnerId,<Transaction::toString()>; entri baru dibuang setelah arsipnya berhasil ditulis.
+    // Jika arsip gagal ditulis, pemadatan dilewati pada putaran ini (dicoba lagi di checkpoint berikutnya).
+    static size_t compactCashFlow()
+    {
+        static Metrics::Counter &compacted = Metrics::getInstance().counter("bank_cash_flow_compacted_total", "Jumlah entri cash flow yang dipadatkan ke checkpoint bulanan");
+        static Metrics::Counter &archiveFailures = Metrics::getInstance().counter("bank_cash_flow_archive_failures_total", "Jumlah pemadatan cash flow yang dilewati karena arsip gagal ditulis");
+        Bank &bank = Bank::getInstance();
+        time_t horizon = bank.cashFlowHorizon();
+        if (horizon <= 0)
+            return 0;
 
-        // Simpan Data Store Transactions
-        std::ofstream transactionFile(TRANSACTION_FILE);
-        if (transactionFile.is_open())
+        if (bank.isCashFlowArchived())
         {
-            for (const auto &pair : Store::getInstance().getStoreTransactions())
+            std::vector<std::pair<Id, Transaction>> archived;
+            bank.collectCompactable(horizon, archived);
+            if (!archived.empty())
             {
-                transactionFile << pair.second.toString() << "\n";
+                std::ofstream archiveFile(CASHFLOW_ARCHIVE_FILE, std::ios::app);
+                for (const auto &entry : archived)
+                    archiveFile << entry.first << "," << entry.second.toString() << "\n";
+                archiveFile.flush();
+                if (!archiveFile.is_open() || archiveFile.fail())
+                {
+                    archiveFailures.increment();
+                    std::cout << "Error: Gagal menulis " << CASHFLOW_ARCHIVE_FILE << ", pemadatan cash flow ditunda." << std::endl;
+                    return 0;
+                }
             }
-            transactionFile.close();
-            std::cout << "Store Transactions saved." << std::endl;
         }
+
+        size_t folded = bank.compactCashFlows(horizon);
+        compacted.increment(folded);
+        return folded;
+    }
+
+    // Tulis hanya record yang berubah sejak checkpoint/snapshot terakhir. Biaya O(perubahan).
+    // Mengembalikan jumlah record yang ditulis.
+    static size_t saveIncremental()
+    {
+        compactCashFlow();
+        std::set<Id> dirtyUsers, dirtyAccounts, dirtyTransactions;
+        std::set<ChangeTracker::ItemKey> dirtyItems;
+        uint64_t journalPosition = Journal::getInstance().getPosition();
+        ChangeTracker::getInstance().takeAll(dirtyUsers, dirtyItems, dirtyAccounts, dirtyTransactions);
+
+        size_t written = dirtyUsers.size() + dirtyItems.size() + dirtyAccounts.size() + dirtyTransactions.size();
+        if (written == 0)
+            return 0;
+
+        std::ofstream logFile(CHECKPOINT_FILE, std::ios::app);
+        if (!logFile.is_open())
+        {
+            std::cout << "Error: Gagal membuka " << CHECKPOINT_FILE << std::endl;
+            return 0;
+        }
+
+        const auto &users = Store::getInstance().getUsers();
+        for (const Id &userId : dirtyUsers)
+        {
+            auto it = users.find(userId);
+            if (it == users.end())
+                continue;
+            SellerPtr seller = std::dynamic_pointer_cast<Seller>(it->second);
+            logFile << "U|" << userId << "|" << it->second->getVersion() << "|"
+                    << (seller ? seller->toHeaderString() : it->second->toString()) << "\n";
+        }
+
+        for (const auto &key : dirtyItems)
+        {
+            auto it = users.find(key.first);
+            SellerPtr seller = it == users.end() ? nullptr : std::dynamic_pointer_cast<Seller>(it->second);
+            Item *item = seller ? seller->getItem(key.second) : nullptr;
+            if (!item)
+                continue;
+            logFile << "I|" << key.first << "/" << key.second << "|" << seller->getCatalogVersion() << "|"
+                    << item->toString() << "\n";
+        }
+
+        for (const Id &ownerId : dirtyAccounts)
+        {
+            BankAccountPtr account = Bank::getInstance().getAccount(ownerId);
+            if (!account)
+                continue;
+            logFile << "A|" << account->getId() << "|" << account->getVersion() << "|" << account->toString() << "\n";
+        }
+
+        const auto &transactions = Store::getInstance().getStoreTransactions();
+        for (const Id &tId : dirtyTransactions)
+        {
+            auto it = transactions.find(tId);
+            if (it == transactions.end())
+                continue;
+            logFile << "T|" << tId << "|" << journalPosition << "|" << it->second.toString() << "\n";
+        }
+
+        logFile << "J|batch|" << journalPosition << "|\n";
+        logFile.flush();
+        return written;
+    }
+
+    // Padatkan log checkpoint: buang batch yang sudah tercakup snapshot penuh,
+    // dan simpan hanya record terakhir untuk setiap kunci.
+    static void compactCheckpointLog()
+    {
+        uint64_t covered = readSnapshotJournal();
+        std::ifstream in(CHECKPOINT_FILE);
+        if (!in.is_open())
+            return;
+
+        std::map<std::string, std::string> latest; // "Jenis|Kunci" -> baris lengkap
+        std::vector<std::string> batch;
+        uint64_t lastPosition = 0;
+        std::string line;
+        while (std::getline(in, line))
+        {
+            if (line.rfind("J|", 0) != 0)
+            {
+                batch.push_back(line);
+                continue;
+            }
+            std::vector<std::string_view> marker;
+            split(line, '|', marker);
+            uint64_t position = 0;
+            if (marker.size() < 3 || !parseNumber(marker[2], position))
+                position = 0;
+            if (position > covered)
+            {
+                for (const std::string &record : batch)
+                {
+                    size_t keyEnd = record.find('|', 2);
+                    latest[record.substr(0, keyEnd)] = record;
+                }
+                lastPosition = position;
+            }
+            batch.clear(); // Record tanpa penanda J (batch tidak lengkap) diabaikan
+        }
+        in.close();
+
+        std::ofstream out(CHECKPOINT_FILE + ".tmp", std::ios::trunc);
+        for (const auto &pair : latest)
+        {
+            out << pair.second << "\n";
+        }
+        if (!latest.empty())
+        {
+            out << "J|batch|" << lastPosition << "|\n";
+        }
+        out.close();
+        std::rename((CHECKPOINT_FILE + ".tmp").c_str(), CHECKPOINT_FILE.c_str());
+        std::cout << "Log checkpoint dipadatkan: " << latest.size() << " record." << std::endl;
+    }
+
+    // --- Save Data ---
+    static void saveData()
+    {
+        static Metrics::Histogram &latency = Metrics::getInstance().histogram("persistence_save_seconds", "Latensi DataPersistence::saveData");
+        Metrics::ScopedTimer timer(latency);
+        std::cout << "Saving data (Serialization)..." << std::endl;
+        collectSnapshot(); // Jangan sampai dua penulis mengakses file yang sama
+        compactCashFlow();
+
+        std::shared_ptr<StoreSnapshot> snapshot = captureSnapshot();
+        if (writeSnapshot(*snapshot))
+        {
+            // Snapshot penuh mencakup seluruh isi log checkpoint, jadi log bisa dikosongkan
+            std::ofstream(CHECKPOINT_FILE, std::ios::trunc);
+            std::cout << "Users, Accounts & Store Transactions saved (journal " << snapshot->journalPosition << ")." << std::endl;
+        }
+        else
+        {
+            ChangeTracker::getInstance().restore(snapshot->changes);
+            std::cout << "Error: Gagal menyimpan data." << std::endl;
+        }
+    }
+
+    // --- Read Replica ---
+    // Salin record yang berubah sejak penerbitan sebelumnya ke delta untuk replica, O(perubahan). Seluruh
+    // state disalin hanya pada penerbitan pertama atau setelah state dimuat/diisi massal. ChangeTracker untuk
+    // checkpoint tidak disentuh karena snapshot ini tidak ditulis ke disk. Dipanggil secara exclusive.
+    static std::shared_ptr<ReplicaImage> captureReplicaChanges()
+    {
+        auto delta = std::make_shared<ReplicaImage>();
+        delta->journalPosition = Journal::getInstance().getPosition();
+        delta->takenAt = DateUtility::getCurrentTime();
+        ChangeTracker::Changes changes;
+        delta->complete = !ChangeTracker::getInstance().takeReplica(changes);
+        DailyRollups::Days changedDays = DailyRollups::getInstance().takeChanged(delta->rollupDays);
+
+        Store &store = Store::getInstance();
+        Bank &bank = Bank::getInstance();
+        const auto &users = store.getUsers();
+        const auto &transactions = store.getStoreTransactions();
+        auto copyUser = [&](const Id &userId)
+        {
+            auto it = users.find(userId);
+            if (it != users.end())
+                delta->users.insert_or_assign(userId, it->second->clone());
+        };
+        auto copyAccount = [&](const Id &ownerId)
+        {
+            BankAccountPtr account = bank.getAccount(ownerId);
+            if (!account)
+                return;
+            delta->accounts.insert_or_assign(ownerId, AccountRecord{account->getId(), ownerId, account->getBalance()});
+            delta->cashFlows.insert_or_assign(ownerId, account->getCashFlowSince(0));
+            delta->cashFlowCheckpoints.insert_or_assign(ownerId, account->getCashFlowCheckpoints());
+        };
+        auto copyTransaction = [&](const Id &tId)
+        {
+            auto it = transactions.find(tId);
+            if (it != transactions.end())
+                delta->transactions.insert_or_assign(tId, it->second);
+        };
+
+        if (delta->complete)
+        {
+            for (const auto &pair : users)
+                copyUser(pair.first);
+            for (const auto &pair : bank.getAccounts())
+                copyAccount(pair.second->getOwnerId());
+            for (const auto &pair : transactions)
+                copyTransaction(pair.first);
+            delta->rollups = DailyRollups::getInstance().copy();
+            return delta;
+        }
+
+        for (const Id &userId : changes.users)
+        {
+            copyUser(userId);
+            copyAccount(userId); // Akun dibuat bersama user
+        }
+        for (const auto &key : changes.items)
+            copyUser(key.first); // Item ikut klon seller
+        for (const Id &ownerId : changes.accounts)
+            copyAccount(ownerId);
+        for (const Id &tId : changes.transactions)
+            copyTransaction(tId);
+        delta->rollups = std::move(changedDays);
+        return delta;
+    }
+
+    // Gabungkan delta dari captureReplicaChanges ke image. Tidak menyentuh Store/Bank.
+    static void applyReplicaChanges(ReplicaImage &image, ReplicaImage &&delta)
+    {
+        if (delta.complete)
+        {
+            image = std::move(delta);
+            image.rollupDays.clear();
+            return;
+        }
+        image.journalPosition = delta.journalPosition;
+        image.takenAt = delta.takenAt;
+        for (auto &pair : delta.users)
+            image.users.insert_or_assign(pair.first, std::move(pair.second));
+        for (auto &pair : delta.accounts)
+            image.accounts.insert_or_assign(pair.first, std::move(pair.second));
+        for (auto &pair : delta.transactions)
+            image.transactions.insert_or_assign(pair.first, std::move(pair.second));
+        for (auto &pair : delta.cashFlows)
+            image.cashFlows.insert_or_assign(pair.first, std::move(pair.second));
+        for (auto &pair : delta.cashFlowCheckpoints)
+            image.cashFlowCheckpoints.insert_or_assign(pair.first, std::move(pair.second));
+        for (int64_t day : delta.rollupDays)
+        {
+            auto it = delta.rollups.find(day);
+            if (it == delta.rollups.end())
+                image.rollups.erase(day);
+            else
+                image.rollups.insert_or_assign(day, std::move(it->second));
+        }
+    }
+
+    // Serialisasi image (format yang sama dengan file snapshot, lihat SharedSnapshot::Section) lalu
+    // terbitkan ke shared memory. Tidak menyentuh Store/Bank, aman dijalankan di thread background.
+    static bool publishReplica(SharedSnapshot::Publisher &publisher, const ReplicaImage &image)
+    {
+        static Metrics::Histogram &latency = Metrics::getInstance().histogram("replica_publish_seconds", "Latensi serialisasi + penerbitan snapshot replica");
+        Metrics::ScopedTimer timer(latency);
+
+        std::vector<std::string> sections(SharedSnapshot::SECTION_COUNT);
+        std::ostringstream users, accounts, rollups, checkpoints;
+        for (const auto &pair : image.users)
+            users << pair.second->toString() << "\n";
+        for (const auto &pair : image.accounts)
+            accounts << pair.second.toString() << "\n";
+        writeRollups(rollups, image.rollups);
+        checkpoints.precision(17);
+        for (const auto &pair : image.cashFlowCheckpoints)
+        {
+            for (const CashFlowCheckpoint &c : pair.second)
+                checkpoints << pair.first << "|" << c.month << "|" << c.openingBalance << "|" << c.count << "|" << c.topup
+                            << "|" << c.withdraw << "|" << c.debit << "|" << c.credit << "|" << c.lastDate << "\n";
+        }
+
+        std::vector<const Transaction *> transactions, cashFlows;
+        transactions.reserve(image.transactions.size());
+        for (const auto &pair : image.transactions)
+            transactions.push_back(&pair.second);
+        for (const auto &pair : image.cashFlows)
+        {
+            for (const Transaction &t : pair.second)
+                cashFlows.push_back(&t);
+        }
+        sections[SharedSnapshot::USERS] = users.str();
+        sections[SharedSnapshot::ACCOUNTS] = accounts.str();
+        sections[SharedSnapshot::TRANSACTIONS] = LedgerFormat::encode(std::move(transactions));
+        sections[SharedSnapshot::ROLLUPS] = rollups.str();
+        sections[SharedSnapshot::CASH_FLOWS] = LedgerFormat::encode(std::move(cashFlows));
+        sections[SharedSnapshot::CASH_FLOW_CHECKPOINTS] = checkpoints.str();
+        return publisher.publish(sections, image.journalPosition, image.takenAt);
+    }
+
+    // Ganti seluruh state Store & Bank dengan snapshot yang sedang dipetakan reader (proses replica).
+    // Parsing berjalan paralel seperti loadData; tidak ada yang ditulis ke disk.
+    static void loadReplica(const SharedSnapshot::Reader &reader)
+    {
+        static Metrics::Histogram &latency = Metrics::getInstance().histogram("replica_load_seconds", "Latensi memuat snapshot replica dari shared memory");
+        Metrics::ScopedTimer timer(latency);
+
+        auto userChunks = parseLinesParallel<UserPtr>(reader.section(SharedSnapshot::USERS), parseUserRecord);
+        auto accountChunks = parseLinesParallel<AccountRecord>(reader.section(SharedSnapshot::ACCOUNTS), parseAccount);
+        auto transactionChunks = loadLedgerParallel(reader.section(SharedSnapshot::TRANSACTIONS), "snapshot replica (transaksi)");
+        auto cashFlowChunks = loadLedgerParallel(reader.section(SharedSnapshot::CASH_FLOWS), "snapshot replica (cash flow)");
+        auto checkpointChunks = parseLinesParallel<std::pair<Id, CashFlowCheckpoint>>(reader.section(SharedSnapshot::CASH_FLOW_CHECKPOINTS), parseCashFlowCheckpoint);
+        DailyRollups::Days days;
+        parseRollups(reader.section(SharedSnapshot::ROLLUPS), days);
+
+        Store &store = Store::getInstance();
+        Bank &bank = Bank::getInstance();
+        store.clear();
+        bank.clear();
+        restoreUsers(userChunks);
+        restoreTransactions(transactionChunks);
+
+        // Cash flow dicatat ulang per akun (satu entri Ledger per sisi), lalu saldo ditimpa nilai snapshot
+        for (const auto &chunk : cashFlowChunks)
+        {
+            for (const Transaction &t : chunk)
+            {
+                if (BankAccountPtr account = bank.getAccount(t.getBuyerId()))
+                    account->recordHistorical(t);
+            }
+        }
+        std::unordered_map<Id, std::vector<CashFlowCheckpoint>> checkpoints;
+        for (const auto &chunk : checkpointChunks)
+        {
+            for (const auto &pair : chunk)
+                checkpoints[pair.first].push_back(pair.second);
+        }
+        for (auto &pair : checkpoints)
+        {
+            if (BankAccountPtr account = bank.getAccount(pair.first))
+                account->restoreCheckpoints(std::move(pair.second));
+        }
+        restoreBalances(accountChunks);
+
+        DailyRollups::getInstance().replace(std::move(days)); // Menimpa agregat akun dari pencatatan ulang cash flow
+        store.rebuildSketches();
+        Journal::getInstance().setPosition(reader.header().journalPosition);
+        ChangeTracker::getInstance().clear();
+    }
+
+    // --- Export Metrics ---
+    // Laporan memori dalam format CSV (memory.csv), untuk melacak regresi antar versi
+    static bool exportMemoryReport(const MemoryFootprint::Report &report)
+    {
+        {
+            std::ofstream out(MEMORY_FILE + ".tmp", std::ios::trunc);
+            if (!out.is_open())
+                return false;
+            out << MemoryFootprint::toCsv(report);
+        }
+        return std::rename((MEMORY_FILE + ".tmp").c_str(), MEMORY_FILE.c_str()) == 0;
+    }
+
+    // Tulis metrics dalam format eksposisi teks Prometheus (ditulis ke .tmp lalu rename agar scraper tidak membaca file setengah jadi)
+    static bool exportMetrics()
+    {
+        {
+            std::ofstream out(METRICS_FILE + ".tmp", std::ios::trunc);
+            if (!out.is_open())
+                return false;
+            out << Metrics::getInstance().toPrometheus();
+        }
+        return std::rename((METRICS_FILE + ".tmp").c_str(), METRICS_FILE.c_str()) == 0;
     }
 };
 
 const std::string DataPersistence::USER_FILE = "users.dat";
 const std::string DataPersistence::ACCOUNT_FILE = "accounts.dat";
 const std::string DataPersistence::TRANSACTION_FILE = "transactions.dat";
+const std::string DataPersistence::LEDGER_FILE = "transactions.ldg";
+const std::string DataPersistence::SNAPSHOT_META_FILE = "snapshot.meta";
+const std::string DataPersistence::CHECKPOINT_FILE = "checkpoint.log";
+const std::string DataPersistence::ROLLUP_FILE = "rollups.dat";
+const std::string DataPersistence::METRICS_FILE = "metrics.prom";
+const std::string DataPersistence::MEMORY_FILE = "memory.csv";
+const std::string DataPersistence::CASHFLOW_ARCHIVE_FILE = "cashflow_archive.log";
+std::future<bool> DataPersistence::pendingSnapshot;
 
 #endif // DATAPERSISTENCE_H
\ No newline at end of file
@@ -3,26 +3,77 @@
 #ifndef DATEUTILITY_H
 #define DATEUTILITY_H
 
+#include <cstdint>
 #include <ctime>
 #include <iostream>
 #include <iomanip>
 #include <chrono>
+#include <functional>
+#include <sstream>
 
 class DateUtility
 {
 public:
+    // Sumber waktu yang bisa diganti (mis. jam simulasi untuk data historis/pengujian).
+    // Kosong berarti memakai jam sistem.
+    using ClockSource = std::function<time_t()>;
+
+private:
+    static ClockSource &clockSource()
+    {
+        static ClockSource source;
+        return source;
+    }
+
+public:
+    // Ganti sumber waktu. Panggil sebelum thread lain mulai membaca waktu.
+    static void setClock(ClockSource source)
+    {
+        clockSource() = std::move(source);
+    }
+
+    // Kembali ke jam sistem
+    static void resetClock()
+    {
+        clockSource() = nullptr;
+    }
+
     // Mendapatkan waktu saat ini sebagai time_t
     static time_t getCurrentTime()
     {
-        return std::time(nullptr);
+        const ClockSource &source = clockSource();
+        return source ? source() : std::time(nullptr);
+    }
+
+    // Awal hari (UTC) dari waktu t
+    static time_t startOfDay(time_t t)
+    {
+        return t - (t % 86400);
+    }
+
+    // Nomor bulan (UTC) dari waktu t: tahun * 12 + (bulan - 1)
+    static int64_t monthOf(time_t t)
+    {
+        std::tm utc{};
+        gmtime_r(&t, &utc);
+        return static_cast<int64_t>(utc.tm_year + 1900) * 12 + utc.tm_mon;
+    }
+
+    // "YYYY-MM" dari nomor bulan monthOf
+    static std::string monthToString(int64_t month)
+    {
+        std::ostringstream ss;
+        ss << month / 12 << "-" << std::setw(2) << std::setfill('0') << month % 12 + 1;
+        return ss.str();
     }
 
     // Mengubah time_t menjadi string yang mudah dibaca
     static std::string timeToString(time_t time)
     {
-        std::tm *ltm = std::localtime(&time);
+        std::tm ltm{};
+        localtime_r(&time, &ltm); // Versi reentrant: aman dipanggil dari laporan paralel
         std::stringstream ss;
-        ss << std::put_time(ltm, "%Y-%m-%d %H:%M:%S");
+        ss << std::put_time(&ltm, "%Y-%m-%d %H:%M:%S");
         return ss.str();
     }
 
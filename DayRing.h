@@ -0,0 +1,58 @@
+// File: DayRing.h
+
+#ifndef DAYRING_H
+#define DAYRING_H
+
+#include <array>
+#include <cstdint>
+#include <ctime>
+
+// Ring berisi satu sketch per hari (UTC) untuk DAYS hari terakhir.
+// Slot milik hari yang sudah keluar jendela dikosongkan (T::clear) saat dipakai ulang,
+// sehingga memori tetap dan jendela mana pun di dalam ring bisa digabung dari slot hariannya.
+template <typename T, int DAYS>
+class DayRing
+{
+private:
+    std::array<T, DAYS> slots;
+    std::array<int64_t, DAYS> dayIds;
+
+public:
+    explicit DayRing(const T &empty = T())
+    {
+        slots.fill(empty);
+        dayIds.fill(-1);
+    }
+
+    static int64_t dayOf(time_t t) { return static_cast<int64_t>(t) / 86400; }
+
+    // Slot untuk hari dari 'date'. create = false hanya mengembalikan slot yang sudah berisi hari itu.
+    // nullptr jika hari tersebut sudah lebih tua dari isi ring.
+    T *slotFor(time_t date, bool create)
+    {
+        int64_t day = dayOf(date);
+        size_t slot = static_cast<size_t>(day % DAYS);
+        if (dayIds[slot] != day)
+        {
+            if (!create || dayIds[slot] > day)
+                return nullptr;
+            slots[slot].clear();
+            dayIds[slot] = day;
+        }
+        return &slots[slot];
+    }
+
+    // Panggil fn(slot) untuk setiap hari sejak hari dari 'since'
+    template <typename Fn>
+    void forEachSince(time_t since, Fn fn) const
+    {
+        int64_t fromDay = dayOf(since);
+        for (int i = 0; i < DAYS; ++i)
+        {
+            if (dayIds[i] >= fromDay)
+                fn(slots[i]);
+        }
+    }
+};
+
+#endif // DAYRING_H
@@ -0,0 +1,140 @@
+// File: HyperLogLog.h
+
+#ifndef HYPERLOGLOG_H
+#define HYPERLOGLOG_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "DayRing.h"
+#include "Id.h"
+
+// Estimator kardinalitas HyperLogLog (2^PRECISION register 1 byte, error standar ~1.04/sqrt(m) = ~3%).
+// Register baru dialokasikan saat ada data pertama, sehingga hari tanpa transaksi tidak memakan memori.
+// Dua sketch digabung dengan max per register (hasilnya sama dengan sketch atas gabungan datanya).
+class HyperLogLog
+{
+public:
+    static constexpr int PRECISION = 10;
+    static constexpr size_t REGISTERS = size_t(1) << PRECISION;
+
+private:
+    std::vector<uint8_t> registers; // Kosong = belum ada data
+
+    static uint64_t hashOf(const Id &key)
+    {
+        // Hash yang sudah tersimpan di Id lalu finalizer splitmix64 agar bit tinggi & rendah tersebar merata
+        uint64_t x = static_cast<uint64_t>(key.hash());
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+public:
+    void add(const Id &key)
+    {
+        if (registers.empty())
+            registers.assign(REGISTERS, 0);
+        uint64_t h = hashOf(key);
+        size_t index = static_cast<size_t>(h >> (64 - PRECISION));
+        uint64_t rest = h << PRECISION;
+        uint8_t rank = rest == 0 ? static_cast<uint8_t>(64 - PRECISION + 1) : static_cast<uint8_t>(__builtin_clzll(rest) + 1);
+        registers[index] = std::max(registers[index], rank);
+    }
+
+    void merge(const HyperLogLog &other)
+    {
+        if (other.registers.empty())
+            return;
+        if (registers.empty())
+        {
+            registers = other.registers;
+            return;
+        }
+        for (size_t i = 0; i < REGISTERS; ++i)
+            registers[i] = std::max(registers[i], other.registers[i]);
+    }
+
+    uint64_t estimate() const
+    {
+        if (registers.empty())
+            return 0;
+        const double m = static_cast<double>(REGISTERS);
+        double sum = 0.0;
+        size_t zeros = 0;
+        for (uint8_t r : registers)
+        {
+            sum += std::ldexp(1.0, -r);
+            if (r == 0)
+                zeros++;
+        }
+        double alpha = 0.7213 / (1.0 + 1.079 / m);
+        double estimate = alpha * m * m / sum;
+        if (estimate <= 2.5 * m && zeros > 0)
+            estimate = m * std::log(m / static_cast<double>(zeros)); // Koreksi rentang kecil (linear counting)
+        return static_cast<uint64_t>(std::llround(estimate));
+    }
+
+    void clear()
+    {
+        std::vector<uint8_t>().swap(registers); // Lepas memori slot hari yang didaur ulang
+    }
+};
+
+// Jumlah buyer unik per seller dan per item milik seller, dalam ring harian sehingga jendela berapa pun
+// (sampai WINDOW_DAYS hari) dihitung dengan menggabungkan sketch harian.
+// Pembatalan tidak bisa dikurangi dari HLL; buyer tetap terhitung sebagai pernah membeli.
+class CustomerReach
+{
+public:
+    static constexpr int WINDOW_DAYS = 31;
+
+private:
+    using Ring = DayRing<HyperLogLog, WINDOW_DAYS>;
+
+    std::unordered_map<Id, Ring> bySeller;                             // SellerId -> ring harian
+    std::unordered_map<Id, std::unordered_map<Id, Ring>> bySellerItem; // SellerId -> ItemId -> ring harian
+
+    static uint64_t uniqueSince(const std::unordered_map<Id, Ring> &rings, const Id &key, time_t since)
+    {
+        auto it = rings.find(key);
+        if (it == rings.end())
+            return 0;
+        HyperLogLog merged;
+        it->second.forEachSince(since, [&](const HyperLogLog &day)
+                                { merged.merge(day); });
+        return merged.estimate();
+    }
+
+public:
+    void record(const Id &sellerId, const Id &itemId, const Id &buyerId, time_t date)
+    {
+        if (HyperLogLog *day = bySeller[sellerId].slotFor(date, true))
+            day->add(buyerId);
+        if (HyperLogLog *day = bySellerItem[sellerId][itemId].slotFor(date, true))
+            day->add(buyerId);
+    }
+
+    uint64_t uniqueBuyersOfSeller(const Id &sellerId, time_t since) const
+    {
+        return uniqueSince(bySeller, sellerId, since);
+    }
+
+    // Hanya buyer yang membeli item ini dari seller tersebut (ItemId bisa dipakai beberapa seller)
+    uint64_t uniqueBuyersOfItem(const Id &sellerId, const Id &itemId, time_t since) const
+    {
+        auto it = bySellerItem.find(sellerId);
+        return it == bySellerItem.end() ? 0 : uniqueSince(it->second, itemId, since);
+    }
+
+    void clear()
+    {
+        bySeller.clear();
+        bySellerItem.clear();
+    }
+};
+
+#endif // HYPERLOGLOG_H
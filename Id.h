@@ -0,0 +1,119 @@
+// File: Id.h
+
+#ifndef ID_H
+#define ID_H
+
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// ID entitas (UserId, AccountId, ItemId, TransactionId) yang disimpan inline dengan kapasitas tetap:
+// tidak pernah memakai heap, bisa disalin dengan memcpy, dan hash-nya dihitung sekali saat dibuat
+// sehingga lookup di unordered_map / pemilihan shard tidak meng-hash ulang string.
+//
+// ID lebih panjang dari CAPACITY tidak bisa disimpan. Konversi dari string yang terlalu panjang tetap
+// menghasilkan objek (agar lookup dari input user aman), tetapi ditandai tidak valid dan tidak pernah sama
+// dengan ID valid mana pun. Tempat pembuatan ID baru wajib memeriksa Id::fits.
+class Id
+{
+public:
+    static constexpr size_t CAPACITY = 19;
+
+private:
+    static constexpr uint8_t TOO_LONG = 0xFF;
+
+    uint32_t hashValue = 0;
+    uint8_t length = 0;
+    char chars[CAPACITY] = {};
+
+    static uint32_t hashOf(std::string_view s)
+    {
+        size_t h = std::hash<std::string_view>()(s);
+        return static_cast<uint32_t>(h ^ (h >> 32));
+    }
+
+public:
+    Id() = default;
+    Id(std::string_view s) : hashValue(hashOf(s))
+    {
+        length = s.size() <= CAPACITY ? static_cast<uint8_t>(s.size()) : TOO_LONG;
+        std::memcpy(chars, s.data(), s.size() <= CAPACITY ? s.size() : CAPACITY);
+    }
+    Id(const std::string &s) : Id(std::string_view(s)) {}
+    Id(const char *s) : Id(std::string_view(s)) {}
+
+    static bool fits(std::string_view s) { return s.size() <= CAPACITY; }
+
+    // Gabungkan prefix + s langsung ke buffer inline (mis. "BA_" + UserId) tanpa std::string sementara
+    static Id join(std::string_view prefix, std::string_view s)
+    {
+        char buffer[2 * CAPACITY + 1];
+        if (prefix.size() + s.size() > sizeof(buffer))
+            return Id(std::string(prefix) + std::string(s)); // Tetap ditandai terlalu panjang
+        std::memcpy(buffer, prefix.data(), prefix.size());
+        std::memcpy(buffer + prefix.size(), s.data(), s.size());
+        return Id(std::string_view(buffer, prefix.size() + s.size()));
+    }
+
+    // prefix + nomor desimal (mis. "S" + 4567), untuk ID transaksi berurutan
+    static Id numbered(std::string_view prefix, uint64_t number)
+    {
+        char digits[20];
+        char *end = std::to_chars(digits, digits + sizeof(digits), number).ptr;
+        return join(prefix, std::string_view(digits, end - digits));
+    }
+
+    bool valid() const { return length != TOO_LONG; }
+    bool empty() const { return length == 0; }
+    size_t size() const { return valid() ? length : CAPACITY; }
+    size_t hash() const { return hashValue; }
+
+    std::string_view view() const { return std::string_view(chars, size()); }
+    std::string str() const { return std::string(view()); }
+    operator std::string_view() const { return view(); }
+    explicit operator std::string() const { return str(); }
+
+    friend bool operator==(const Id &a, const Id &b)
+    {
+        return a.hashValue == b.hashValue && a.length == b.length && std::memcmp(a.chars, b.chars, a.size()) == 0;
+    }
+    friend bool operator!=(const Id &a, const Id &b) { return !(a == b); }
+    // Urutan sama dengan urutan string, sehingga std::map<Id, ...> tetap tersusun seperti sebelumnya.
+    // ID tidak valid diurutkan setelah semua ID valid agar tidak pernah setara dengan prefix-nya.
+    friend bool operator<(const Id &a, const Id &b)
+    {
+        if (a.valid() != b.valid())
+            return a.valid();
+        return a.view() < b.view();
+    }
+    friend bool operator>(const Id &a, const Id &b) { return b < a; }
+
+    friend bool operator==(const Id &a, const char *b) { return a.valid() && a.view() == b; }
+    friend bool operator!=(const Id &a, const char *b) { return !(a == b); }
+    friend bool operator==(const Id &a, const std::string &b) { return a.valid() && a.view() == b; }
+    friend bool operator!=(const Id &a, const std::string &b) { return !(a == b); }
+
+    friend std::string operator+(const std::string &a, const Id &b) { return a + std::string(b.view()); }
+    friend std::string operator+(const char *a, const Id &b) { return std::string(a) + b; }
+    friend std::string operator+(const Id &a, const std::string &b) { return a.str() + b; }
+    friend std::string operator+(const Id &a, const char *b) { return a.str() + b; }
+    friend std::ostream &operator<<(std::ostream &out, const Id &id) { return out << id.view(); }
+};
+
+static_assert(std::is_trivially_copyable<Id>::value && sizeof(Id) == 24, "Id harus inline 24 byte");
+
+namespace std
+{
+    template <>
+    struct hash<Id>
+    {
+        size_t operator()(const Id &id) const { return id.hash(); }
+    };
+}
+
+#endif // ID_H
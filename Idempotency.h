@@ -0,0 +1,138 @@
+// File: Idempotency.h
+
+#ifndef IDEMPOTENCY_H
+#define IDEMPOTENCY_H
+
+#include <ctime>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include "Metrics.h"
+
+// Dedupe permintaan yang membawa idempotency key dari client (pembelian, topup, withdraw).
+// Permintaan ulang (retry setelah timeout) dengan kunci yang sama mengembalikan hasil aslinya tanpa
+// menyentuh stok atau saldo. Kunci diingat selama TTL_SEC sejak pertama kali terlihat (hanya di memori).
+// Setiap kunci menyimpan sidik permintaannya (operasi + argumen); kunci yang dipakai ulang untuk
+// permintaan lain ditolak (CONFLICT), bukan dibalas dengan hasil permintaan pertama.
+class Idempotency
+{
+public:
+    static constexpr time_t TTL_SEC = 600;
+
+    struct Result
+    {
+        bool ok = false;
+        std::string body; // Output asli untuk user
+    };
+
+    enum class Status
+    {
+        NEW,         // Kunci baru: jalankan permintaan lalu panggil finish()
+        REPLAY,      // Sudah selesai sebelumnya: kembalikan hasil yang tersimpan
+        IN_PROGRESS, // Permintaan asli masih berjalan
+        CONFLICT     // Kunci sudah dipakai untuk operasi/argumen lain: tolak
+    };
+
+private:
+    struct Entry
+    {
+        time_t seenAt;
+        std::string request; // Sidik permintaan, lihat requestOf()
+        bool done;
+        Result result;
+    };
+
+    std::mutex mtx;
+    std::unordered_map<std::string, Entry> entries;
+    std::deque<std::pair<time_t, std::string>> expiry; // Urut waktu pertama terlihat
+
+    // Konsep Singleton
+    Idempotency() = default;
+    Idempotency(const Idempotency &) = delete;
+    Idempotency &operator=(const Idempotency &) = delete;
+
+    // Buang kunci kedaluwarsa (dipanggil di bawah mtx)
+    void expire(time_t now)
+    {
+        while (!expiry.empty() && now - expiry.front().first >= TTL_SEC)
+        {
+            auto it = entries.find(expiry.front().second);
+            if (it != entries.end() && it->second.seenAt == expiry.front().first)
+                entries.erase(it);
+            expiry.pop_front();
+        }
+    }
+
+public:
+    static Idempotency &getInstance()
+    {
+        static Idempotency instance;
+        return instance;
+    }
+
+    // Kunci dibatasi per user agar kunci yang sama dari user berbeda tidak bertabrakan. Operasi sengaja
+    // tidak masuk ke kunci tetapi ke sidik permintaan, agar TOPUP lalu WITHDRAW dengan kunci sama ditolak.
+    static std::string scopedKey(std::string_view userId, const std::string &key)
+    {
+        return std::string(userId) + "|" + key;
+    }
+
+    // Sidik permintaan: operasi beserta argumen yang menentukan efeknya (item, jumlah, nominal)
+    static std::string requestOf(std::string_view operation, std::string_view arguments)
+    {
+        return std::string(operation) + " " + std::string(arguments);
+    }
+
+    Status begin(const std::string &key, const std::string &request, Result &replay)
+    {
+        static Metrics::Counter &fresh = Metrics::getInstance().counter("idempotency_requests_total", "Permintaan ber-idempotency key per hasil", "result=\"new\"");
+        static Metrics::Counter &replayed = Metrics::getInstance().counter("idempotency_requests_total", "Permintaan ber-idempotency key per hasil", "result=\"replay\"");
+        static Metrics::Counter &inProgress = Metrics::getInstance().counter("idempotency_requests_total", "Permintaan ber-idempotency key per hasil", "result=\"in_progress\"");
+        static Metrics::Counter &conflict = Metrics::getInstance().counter("idempotency_requests_total", "Permintaan ber-idempotency key per hasil", "result=\"conflict\"");
+
+        time_t now = std::time(nullptr);
+
+        std::lock_guard<std::mutex> lock(mtx);
+        expire(now);
+        // Kunci baru pun harus disisipkan (sebagai "sedang diproses") di bawah lock agar retry yang
+        // datang bersamaan melihatnya, jadi tidak ada jalur tanpa lock untuk kunci yang belum dikenal
+        auto inserted = entries.emplace(key, Entry{now, request, false, Result()});
+        if (inserted.second)
+        {
+            expiry.emplace_back(now, key);
+            fresh.increment();
+            return Status::NEW;
+        }
+
+        const Entry &entry = inserted.first->second;
+        if (entry.request != request)
+        {
+            conflict.increment();
+            return Status::CONFLICT;
+        }
+        if (!entry.done)
+        {
+            inProgress.increment();
+            return Status::IN_PROGRESS;
+        }
+        replay = entry.result;
+        replayed.increment();
+        return Status::REPLAY;
+    }
+
+    // Simpan hasil permintaan yang dimulai dengan begin() == NEW
+    void finish(const std::string &key, Result result)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = entries.find(key);
+        if (it == entries.end())
+            return;
+        it->second.done = true;
+        it->second.result = std::move(result);
+    }
+};
+
+#endif // IDEMPOTENCY_H
@@ -4,33 +4,96 @@
 #define ITEM_H
 
 #include <string>
+#include <atomic>
+#include "MemoryFootprint.h"
+#include "Id.h"
 
 class Item
 {
 private:
-    std::string itemId;
+    Id itemId;
     std::string name;
     double price;
-    int stock;
+    std::atomic<int> stock;    // Stok yang masih tersedia untuk dibeli
+    std::atomic<int> reserved; // Stok yang sudah direservasi tetapi belum di-commit
 
 public:
-    Item(const std::string &id, const std::string &n, double p, int s)
-        : itemId(id), name(n), price(p), stock(s) {}
+    Item(const Id &id, const std::string &n, double p, int s)
+        : itemId(id), name(n), price(p), stock(s), reserved(0) {}
+
+    // std::atomic tidak bisa disalin, jadi salin nilainya (snapshot) secara eksplisit
+    Item(const Item &other)
+        : itemId(other.itemId), name(other.name), price(other.price),
+          stock(other.stock.load()), reserved(other.reserved.load()) {}
+
+    Item &operator=(const Item &other)
+    {
+        itemId = other.itemId;
+        name = other.name;
+        price = other.price;
+        stock.store(other.stock.load());
+        reserved.store(other.reserved.load());
+        return *this;
+    }
 
     // Getter
-    std::string getId() const { return itemId; }
-    std::string getName() const { return name; }
+    const Id &getId() const { return itemId; }
+    const std::string &getName() const { return name; }
     double getPrice() const { return price; }
-    int getStock() const { return stock; }
+    int getStock() const { return stock.load(std::memory_order_acquire); }
+    int getReserved() const { return reserved.load(std::memory_order_acquire); }
 
     // Setter (untuk manajemen stok)
-    void setStock(int s) { stock = s; }
+    void setStock(int s) { stock.store(s, std::memory_order_release); }
+
+    // --- Reservasi Stok (Lock-free) ---
+    // Alur pembelian: reserveStock -> (bayar) -> commitReservation, atau releaseReservation jika gagal.
+    // Compare-and-swap menjamin stok tidak pernah negatif walaupun banyak thread membeli item yang sama.
+    bool reserveStock(int quantity)
+    {
+        if (quantity <= 0)
+            return false;
+
+        int current = stock.load(std::memory_order_acquire);
+        while (current >= quantity)
+        {
+            if (stock.compare_exchange_weak(current, current - quantity,
+                                            std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                reserved.fetch_add(quantity, std::memory_order_relaxed);
+                return true;
+            }
+            // current sudah diperbarui oleh compare_exchange_weak, ulangi pengecekan
+        }
+        return false; // Stok tidak cukup
+    }
+
+    // Reservasi menjadi permanen (barang terjual)
+    void commitReservation(int quantity)
+    {
+        reserved.fetch_sub(quantity, std::memory_order_relaxed);
+    }
+
+    // Reservasi dibatalkan, stok dikembalikan
+    void releaseReservation(int quantity)
+    {
+        reserved.fetch_sub(quantity, std::memory_order_relaxed);
+        stock.fetch_add(quantity, std::memory_order_acq_rel);
+    }
+
+    // Tambah stok secara atomik (replenish / pengembalian stok)
+    void addStock(int quantity)
+    {
+        stock.fetch_add(quantity, std::memory_order_acq_rel);
+    }
 
     // Metode untuk representasi output (untuk serialisasi, kita akan menggunakan string sederhana)
     std::string toString() const
     {
-        return itemId + "," + name + "," + std::to_string(price) + "," + std::to_string(stock);
+        return itemId + "," + name + "," + std::to_string(price) + "," + std::to_string(getStock());
     }
+
+    size_t heapBytes() const { return MemoryFootprint::heap(name); }
 };
 
-#endif // ITEM_H
\ No newline at end of file
+#endif // ITEM_H
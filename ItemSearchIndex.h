@@ -0,0 +1,174 @@
+// File: ItemSearchIndex.h
+
+#ifndef ITEMSEARCHINDEX_H
+#define ITEMSEARCHINDEX_H
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Id.h"
+
+// Index pencarian nama item di seluruh seller (inverted index trigram).
+// Setiap item mendapat docId berurutan; posting list trigram berisi docId menaik sehingga cukup di-append.
+// Query dipecah per kata: kandidat diambil dari posting list trigram terpendek, lalu setiap kandidat
+// diverifikasi (semua kata harus muncul sebagai substring nama). Harga & stok tidak disimpan di sini,
+// melainkan dibaca langsung dari Item milik seller saat hasil ditampilkan.
+class ItemSearchIndex
+{
+public:
+    struct Entry
+    {
+        Id sellerId;
+        Id itemId;
+        std::string name;      // Nama asli untuk ditampilkan
+        std::string lowerName; // Nama huruf kecil untuk pencocokan
+        bool live = true;      // false jika entri digantikan entri baru (nama item berubah)
+    };
+
+private:
+    std::vector<Entry> docs;
+    std::unordered_map<std::string, uint32_t> byKey;                // "SellerId/ItemId" -> docId
+    std::unordered_map<uint32_t, std::vector<uint32_t>> postings;   // Trigram -> docId (menaik)
+
+    static std::string normalize(const std::string &s)
+    {
+        std::string out(s);
+        for (char &c : out)
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        return out;
+    }
+
+    static uint32_t gramAt(const std::string &s, size_t i)
+    {
+        return (static_cast<uint32_t>(static_cast<unsigned char>(s[i])) << 16) |
+               (static_cast<uint32_t>(static_cast<unsigned char>(s[i + 1])) << 8) |
+               static_cast<uint32_t>(static_cast<unsigned char>(s[i + 2]));
+    }
+
+    // Trigram unik dari sebuah string (sudah dinormalisasi)
+    static std::vector<uint32_t> gramsOf(const std::string &s)
+    {
+        std::vector<uint32_t> grams;
+        for (size_t i = 0; i + 3 <= s.size(); ++i)
+            grams.push_back(gramAt(s, i));
+        std::sort(grams.begin(), grams.end());
+        grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+        return grams;
+    }
+
+    static std::vector<std::string> wordsOf(const std::string &s)
+    {
+        std::vector<std::string> words;
+        std::string current;
+        for (char c : s)
+        {
+            if (std::isspace(static_cast<unsigned char>(c)))
+            {
+                if (!current.empty())
+                    words.push_back(std::move(current));
+                current.clear();
+            }
+            else
+            {
+                current += c;
+            }
+        }
+        if (!current.empty())
+            words.push_back(std::move(current));
+        return words;
+    }
+
+    static bool matches(const Entry &entry, const std::vector<std::string> &words)
+    {
+        if (!entry.live)
+            return false;
+        for (const std::string &word : words)
+        {
+            if (entry.lowerName.find(word) == std::string::npos)
+                return false;
+        }
+        return true;
+    }
+
+public:
+    // Tambah/perbarui item. Item yang sudah terindeks dengan nama sama tidak diproses ulang.
+    void add(const Id &sellerId, const Id &itemId, const std::string &name)
+    {
+        std::string key = sellerId + "/" + itemId;
+        auto it = byKey.find(key);
+        if (it != byKey.end())
+        {
+            if (docs[it->second].name == name)
+                return;
+            docs[it->second].live = false; // Posting lama dibiarkan, disaring saat verifikasi
+        }
+
+        uint32_t docId = static_cast<uint32_t>(docs.size());
+        docs.push_back({sellerId, itemId, name, normalize(name), true});
+        for (uint32_t gram : gramsOf(docs.back().lowerName))
+            postings[gram].push_back(docId);
+        byKey[std::move(key)] = docId;
+    }
+
+    // Penghitungan total berhenti setelah batas ini (query umum bisa cocok dengan jutaan item)
+    static constexpr size_t COUNT_LIMIT = 1000;
+
+    // Cari item yang namanya mengandung semua kata pada query (tidak peka huruf besar/kecil).
+    // Mengisi out dengan hasil ke-offset sampai offset+limit-1 (urut registrasi), mengembalikan jumlah hasil.
+    // complete = false jika penghitungan dihentikan di COUNT_LIMIT (total sebenarnya lebih besar).
+    size_t search(const std::string &query, size_t offset, size_t limit, std::vector<const Entry *> &out, bool &complete) const
+    {
+        out.clear();
+        complete = true;
+        std::vector<std::string> words = wordsOf(normalize(query));
+        if (words.empty())
+            return 0;
+
+        // Pilih posting list terpendek dari semua trigram query sebagai kandidat
+        const std::vector<uint32_t> *candidates = nullptr;
+        for (const std::string &word : words)
+        {
+            for (uint32_t gram : gramsOf(word))
+            {
+                auto it = postings.find(gram);
+                if (it == postings.end())
+                    return 0; // Ada trigram yang tidak dimiliki item mana pun
+                if (!candidates || it->second.size() < candidates->size())
+                    candidates = &it->second;
+            }
+        }
+
+        size_t total = 0;
+        size_t stopAt = std::max(offset + limit, COUNT_LIMIT);
+        auto visit = [&](uint32_t docId)
+        {
+            if (!matches(docs[docId], words))
+                return true;
+            if (total >= offset && out.size() < limit)
+                out.push_back(&docs[docId]);
+            return ++total < stopAt;
+        };
+
+        bool finished = true;
+        if (candidates)
+        {
+            for (size_t i = 0; i < candidates->size() && finished; ++i)
+                finished = visit((*candidates)[i]);
+        }
+        else
+        {
+            // Semua kata < 3 huruf: tidak ada trigram, periksa seluruh item
+            for (uint32_t docId = 0; docId < docs.size() && finished; ++docId)
+                finished = visit(docId);
+        }
+        complete = finished;
+        return total;
+    }
+
+    size_t size() const { return byKey.size(); }
+};
+
+#endif // ITEMSEARCHINDEX_H
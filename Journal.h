@@ -0,0 +1,40 @@
+// File: Journal.h
+
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <atomic>
+#include <cstdint>
+
+// Journal menghitung posisi (nomor urut) setiap perubahan state Store/Bank.
+// Snapshot mencatat posisi ini agar diketahui perubahan mana yang sudah tercakup.
+class Journal
+{
+private:
+    std::atomic<uint64_t> position;
+
+    // Konsep Singleton
+    Journal() : position(0) {}
+    Journal(const Journal &) = delete;
+    Journal &operator=(const Journal &) = delete;
+
+public:
+    static Journal &getInstance()
+    {
+        static Journal instance;
+        return instance;
+    }
+
+    // Catat satu perubahan, mengembalikan posisi baru
+    uint64_t advance(uint64_t count = 1)
+    {
+        return position.fetch_add(count, std::memory_order_acq_rel) + count;
+    }
+
+    uint64_t getPosition() const { return position.load(std::memory_order_acquire); }
+
+    // Digunakan saat memuat data agar posisi melanjutkan snapshot terakhir
+    void setPosition(uint64_t p) { position.store(p, std::memory_order_release); }
+};
+
+#endif // JOURNAL_H
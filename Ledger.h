@@ -0,0 +1,185 @@
+// File: Ledger.h
+
+#ifndef LEDGER_H
+#define LEDGER_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <mutex>
+#include "Id.h"
+#include "Transaction.h"
+#include "MemoryFootprint.h"
+
+// Satu pergerakan dana. Tidak menyimpan pihak-pihaknya: arah (masuk/keluar) dan pemilik dibaca dari
+// view yang mereferensikannya (cash flow akun).
+struct LedgerEntry
+{
+    Id transactionId;
+    double amount = 0.0; // Selalu positif
+    time_t date = 0;
+    TransactionType type = TransactionType::PURCHASE;
+};
+
+// Buku besar append-only: setiap pergerakan dana (topup, withdraw, pembayaran pembelian) dicatat tepat
+// sekali. Cash flow pembeli dan penjual hanya menyimpan referensi ke entri yang sama, sehingga kedua sisi
+// transfer tidak mungkin berbeda isi.
+//
+// Entri disimpan dalam potongan (chunk) berukuran tetap yang tidak pernah dipindah. Append tanpa lock:
+// posisi dipesan dengan fetch_add dan chunk/direktori baru dipasang dengan compare-exchange, sehingga
+// operasi akun dari shard berbeda tidak saling menunggu. Entri dibaca tanpa lock setelah posisinya
+// diteruskan ke pembaca (view berlock atau pesan antar shard). Chunk di depan yang tidak lagi
+// direferensikan view mana pun dilepas lewat releaseBefore (setelah cash flow dipadatkan).
+class Ledger
+{
+public:
+    using Position = uint64_t;
+    // Elemen view: (posisi << 1) | 1 jika dana masuk ke pemilik view, 0 jika keluar
+    using Ref = uint64_t;
+
+    static Ref incoming(Position position) { return (position << 1) | 1; }
+    static Ref outgoing(Position position) { return position << 1; }
+    static Position positionOf(Ref ref) { return ref >> 1; }
+    static bool isIncoming(Ref ref) { return ref & 1; }
+
+    // Nilai entri dari sudut pandang pemilik view (negatif = dana keluar)
+    static double signedAmount(const LedgerEntry &entry, Ref ref)
+    {
+        return isIncoming(ref) ? entry.amount : -entry.amount;
+    }
+
+private:
+    static constexpr int CHUNK_BITS = 12;     // 4096 entri per chunk
+    static constexpr int DIRECTORY_BITS = 10; // 1024 chunk per direktori, 1024 direktori = 2^32 entri
+    static constexpr Position CHUNK_SIZE = Position(1) << CHUNK_BITS;
+    static constexpr size_t DIRECTORY_SIZE = size_t(1) << DIRECTORY_BITS;
+
+    struct Chunk
+    {
+        std::array<LedgerEntry, CHUNK_SIZE> entries;
+    };
+    struct Directory
+    {
+        std::array<std::atomic<Chunk *>, DIRECTORY_SIZE> chunks{};
+    };
+
+    std::array<std::atomic<Directory *>, DIRECTORY_SIZE> directories{};
+    mutable std::mutex mtx;             // Melindungi first dan pelepasan chunk
+    std::atomic<Position> published{0}; // Posisi setelah entri terakhir yang dipesan
+    Position first = 0;                 // Entri di bawah posisi ini sudah dilepas (kelipatan CHUNK_SIZE)
+    std::atomic<size_t> chunkCount{0};
+
+    // Konsep Singleton
+    Ledger() = default;
+    Ledger(const Ledger &) = delete;
+    Ledger &operator=(const Ledger &) = delete;
+
+    ~Ledger()
+    {
+        for (auto &slot : directories)
+        {
+            Directory *directory = slot.load(std::memory_order_relaxed);
+            if (!directory)
+                continue;
+            for (auto &chunk : directory->chunks)
+                delete chunk.load(std::memory_order_relaxed);
+            delete directory;
+        }
+    }
+
+    // Pasang objek baru di slot kosong; jika thread lain lebih dulu, pakai miliknya
+    template <typename T>
+    static T *install(std::atomic<T *> &slot, bool &created)
+    {
+        T *current = slot.load(std::memory_order_acquire);
+        created = false;
+        if (current)
+            return current;
+        T *fresh = new T();
+        if (slot.compare_exchange_strong(current, fresh, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            created = true;
+            return fresh;
+        }
+        delete fresh;
+        return current;
+    }
+
+    Chunk *chunkFor(Position position)
+    {
+        bool created;
+        Directory *directory = install(directories[position >> (CHUNK_BITS + DIRECTORY_BITS)], created);
+        Chunk *chunk = install(directory->chunks[(position >> CHUNK_BITS) & (DIRECTORY_SIZE - 1)], created);
+        if (created)
+            chunkCount.fetch_add(1, std::memory_order_relaxed);
+        return chunk;
+    }
+
+public:
+    static Ledger &getInstance()
+    {
+        static Ledger instance;
+        return instance;
+    }
+
+    Position append(const Id &transactionId, double amount, TransactionType type, time_t date = DateUtility::getCurrentTime())
+    {
+        Position position = published.fetch_add(1, std::memory_order_relaxed);
+        LedgerEntry &entry = chunkFor(position)->entries[position & (CHUNK_SIZE - 1)];
+        entry.transactionId = transactionId;
+        entry.amount = amount;
+        entry.date = date;
+        entry.type = type;
+        return position;
+    }
+
+    // Posisi harus sudah dipublikasikan ke pemanggil (lewat view berlock atau pesan antar shard)
+    // dan belum dilepas.
+    const LedgerEntry &at(Position position) const
+    {
+        Directory *directory = directories[position >> (CHUNK_BITS + DIRECTORY_BITS)].load(std::memory_order_acquire);
+        Chunk *chunk = directory->chunks[(position >> CHUNK_BITS) & (DIRECTORY_SIZE - 1)].load(std::memory_order_acquire);
+        return chunk->entries[position & (CHUNK_SIZE - 1)];
+    }
+
+    // Entri yang dipesan append yang masih berjalan ikut terhitung; tepat jika tidak ada append (exclusive)
+    Position end() const { return published.load(std::memory_order_acquire); }
+
+    // Lepas chunk yang seluruh entrinya berada di bawah 'keep'. Pemanggil menjamin tidak ada view yang
+    // masih mereferensikan entri tersebut dan tidak ada append yang berjalan (exclusive).
+    void releaseBefore(Position keep)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        keep = std::min(keep, published.load(std::memory_order_relaxed));
+        while (first + CHUNK_SIZE <= keep)
+        {
+            std::atomic<Directory *> &dirSlot = directories[first >> (CHUNK_BITS + DIRECTORY_BITS)];
+            Directory *directory = dirSlot.load(std::memory_order_relaxed);
+            size_t index = (first >> CHUNK_BITS) & (DIRECTORY_SIZE - 1);
+            delete directory->chunks[index].exchange(nullptr, std::memory_order_acq_rel);
+            chunkCount.fetch_sub(1, std::memory_order_relaxed);
+            if (index == DIRECTORY_SIZE - 1)
+                delete dirSlot.exchange(nullptr, std::memory_order_acq_rel);
+            first += CHUNK_SIZE;
+        }
+    }
+
+    // Perkiraan memori (lihat MemoryFootprint.h). Entri tidak memakai heap, cukup hitung chunk dan direktori.
+    MemoryFootprint::Usage memoryUsage() const
+    {
+        using MF = MemoryFootprint;
+        std::lock_guard<std::mutex> lock(mtx);
+        Position last = published.load(std::memory_order_relaxed);
+        MF::Usage usage{"ledger.entries", static_cast<size_t>(last - first), chunkCount.load(std::memory_order_relaxed) * MF::allocation(sizeof(Chunk))};
+        for (const auto &slot : directories)
+        {
+            if (slot.load(std::memory_order_relaxed))
+                usage.bytes += MF::allocation(sizeof(Directory));
+        }
+        return usage;
+    }
+};
+
+#endif // LEDGER_H
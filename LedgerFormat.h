@@ -0,0 +1,392 @@
+// File: LedgerFormat.h
+
+#ifndef LEDGERFORMAT_H
+#define LEDGERFORMAT_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <cctype>
+#include "Transaction.h"
+
+// Format ledger biner kolumnar untuk transaksi toko (pengganti transactions.dat berbasis teks).
+//
+// File  : "LDG1" diikuti blok-blok berurutan.
+// Blok  : header tetap (jumlah record, waktu min, waktu max, ukuran payload) + payload kolumnar:
+//         kamus ID (item/buyer/seller), kolom TId (prefix + delta angka), kolom indeks kamus,
+//         amount (varint fixed-point, skala per blok), quantity (varint), waktu (delta zigzag),
+//         status/type (run-length).
+// Header blok memuat min/max waktu; waktu min juga menjadi basis delta kolom waktu.
+class LedgerFormat
+{
+public:
+    static constexpr size_t BLOCK_RECORDS = 4096;
+    static constexpr size_t BLOCK_HEADER_SIZE = 4 + 8 + 8 + 4;
+
+    struct BlockHeader
+    {
+        uint32_t recordCount;
+        int64_t minTime;
+        int64_t maxTime;
+        uint32_t payloadSize;
+    };
+
+private:
+    static constexpr double AMOUNT_SCALE = 1000000.0; // Presisi maksimum, sama dengan std::to_string (6 desimal)
+
+    // --- Primitif encoding ---
+    static void putVarint(std::string &out, uint64_t v)
+    {
+        while (v >= 0x80)
+        {
+            out.push_back(static_cast<char>((v & 0x7F) | 0x80));
+            v >>= 7;
+        }
+        out.push_back(static_cast<char>(v));
+    }
+
+    static uint64_t zigzag(int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+    static int64_t unzigzag(uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); }
+
+    static void putString(std::string &out, std::string_view s)
+    {
+        putVarint(out, s.size());
+        out.append(s.data(), s.size());
+    }
+
+    static void putFixed(std::string &out, uint64_t v, int bytes)
+    {
+        for (int i = 0; i < bytes; ++i)
+        {
+            out.push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+        }
+    }
+
+    static uint64_t getFixed(const uint8_t *p, int bytes)
+    {
+        uint64_t v = 0;
+        for (int i = 0; i < bytes; ++i)
+        {
+            v |= static_cast<uint64_t>(p[i]) << (8 * i);
+        }
+        return v;
+    }
+
+    // Pembaca payload dengan batas; valid = false jika data rusak/terpotong
+    struct Cursor
+    {
+        const uint8_t *p;
+        const uint8_t *end;
+        bool valid = true;
+
+        uint64_t varint()
+        {
+            uint64_t v = 0;
+            for (int shift = 0; shift < 64; shift += 7)
+            {
+                if (p >= end)
+                {
+                    valid = false;
+                    return 0;
+                }
+                uint8_t b = *p++;
+                v |= static_cast<uint64_t>(b & 0x7F) << shift;
+                if (!(b & 0x80))
+                    return v;
+            }
+            valid = false;
+            return 0;
+        }
+
+        std::string str()
+        {
+            uint64_t len = varint();
+            if (!valid || static_cast<uint64_t>(end - p) < len)
+            {
+                valid = false;
+                return std::string();
+            }
+            std::string s(reinterpret_cast<const char *>(p), len);
+            p += len;
+            return s;
+        }
+    };
+
+    // Pisahkan TId seperti "S123" menjadi prefix "S" dan angka 123
+    static bool splitNumericId(std::string_view id, std::string &prefix, uint64_t &number)
+    {
+        size_t pos = id.size();
+        while (pos > 0 && std::isdigit(static_cast<unsigned char>(id[pos - 1])))
+            pos--;
+        if (pos == id.size() || id.size() - pos > 18 || (id[pos] == '0' && pos + 1 < id.size()))
+            return false; // Tanpa angka, terlalu panjang, atau ada nol di depan (tidak bisa dibalik)
+        prefix = std::string(id.substr(0, pos));
+        number = std::stoull(std::string(id.substr(pos)));
+        return true;
+    }
+
+public:
+    // Encode satu blok (maks BLOCK_RECORDS transaksi) menjadi header + payload
+    static std::string encodeBlock(const std::vector<const Transaction *> &records)
+    {
+        std::string payload;
+        int64_t minTime = records.empty() ? 0 : records.front()->getDate();
+        int64_t maxTime = minTime;
+        for (const Transaction *t : records)
+        {
+            minTime = std::min<int64_t>(minTime, t->getDate());
+            maxTime = std::max<int64_t>(maxTime, t->getDate());
+        }
+
+        // 1. Kamus ID (item, buyer, seller) - ID yang sama hanya ditulis sekali per blok
+        std::map<Id, uint64_t> dictIndex;
+        std::vector<const Id *> dict; // Menunjuk ke key map (alamatnya stabil)
+        std::vector<uint64_t> itemCol, buyerCol, sellerCol;
+        auto code = [&](const Id &s)
+        {
+            auto res = dictIndex.emplace(s, dict.size());
+            if (res.second)
+                dict.push_back(&res.first->first);
+            return res.first->second;
+        };
+        for (const Transaction *t : records)
+        {
+            itemCol.push_back(code(t->getItemId()));
+            buyerCol.push_back(code(t->getBuyerId()));
+            sellerCol.push_back(code(t->getSellerId()));
+        }
+        putVarint(payload, dict.size());
+        for (const Id *s : dict)
+            putString(payload, *s);
+
+        // 2. Kolom TId: jika semua berbentuk <prefix><angka> dengan prefix sama, simpan delta angka
+        std::string commonPrefix;
+        std::vector<uint64_t> numbers;
+        bool numeric = true;
+        for (const Transaction *t : records)
+        {
+            std::string prefix;
+            uint64_t number = 0;
+            if (!splitNumericId(t->getId(), prefix, number) || (!numbers.empty() && prefix != commonPrefix))
+            {
+                numeric = false;
+                break;
+            }
+            commonPrefix = prefix;
+            numbers.push_back(number);
+        }
+        putVarint(payload, numeric ? 1 : 0);
+        if (numeric)
+        {
+            putString(payload, commonPrefix);
+            int64_t prev = 0;
+            for (uint64_t n : numbers)
+            {
+                putVarint(payload, zigzag(static_cast<int64_t>(n) - prev));
+                prev = static_cast<int64_t>(n);
+            }
+        }
+        else
+        {
+            for (const Transaction *t : records)
+                putString(payload, t->getId());
+        }
+
+        // 3. Kolom indeks kamus
+        for (uint64_t v : itemCol)
+            putVarint(payload, v);
+        for (uint64_t v : buyerCol)
+            putVarint(payload, v);
+        for (uint64_t v : sellerCol)
+            putVarint(payload, v);
+
+        // 4. Amount (fixed-point) dan quantity. Skala blok dipilih sekecil mungkin tanpa kehilangan presisi
+        //    (harga rupiah/sen cukup dengan skala 1 atau 100, sisanya memakai 6 desimal)
+        double scale = 1.0;
+        for (double candidate : {1.0, 100.0, AMOUNT_SCALE})
+        {
+            scale = candidate;
+            bool exact = std::all_of(records.begin(), records.end(), [candidate](const Transaction *t)
+                                     { return std::fabs(std::llround(t->getAmount() * candidate) - t->getAmount() * candidate) < 1e-6; });
+            if (exact)
+                break;
+        }
+        putVarint(payload, static_cast<uint64_t>(scale));
+        for (const Transaction *t : records)
+            putVarint(payload, zigzag(std::llround(t->getAmount() * scale)));
+        for (const Transaction *t : records)
+            putVarint(payload, zigzag(t->getQuantity()));
+
+        // 5. Waktu: delta terhadap record sebelumnya (record diurutkan waktu -> delta kecil)
+        int64_t prevTime = minTime;
+        for (const Transaction *t : records)
+        {
+            putVarint(payload, zigzag(static_cast<int64_t>(t->getDate()) - prevTime));
+            prevTime = t->getDate();
+        }
+
+        // 6. Status & Type digabung satu byte, lalu run-length encoding
+        size_t i = 0;
+        while (i < records.size())
+        {
+            uint8_t value = static_cast<uint8_t>((static_cast<int>(records[i]->getStatus()) << 4) |
+                                                 static_cast<int>(records[i]->getType()));
+            size_t run = 1;
+            while (i + run < records.size() &&
+                   static_cast<uint8_t>((static_cast<int>(records[i + run]->getStatus()) << 4) |
+                                        static_cast<int>(records[i + run]->getType())) == value)
+                run++;
+            putVarint(payload, run);
+            payload.push_back(static_cast<char>(value));
+            i += run;
+        }
+
+        std::string block;
+        block.reserve(BLOCK_HEADER_SIZE + payload.size());
+        putFixed(block, records.size(), 4);
+        putFixed(block, static_cast<uint64_t>(minTime), 8);
+        putFixed(block, static_cast<uint64_t>(maxTime), 8);
+        putFixed(block, payload.size(), 4);
+        block.append(payload);
+        return block;
+    }
+
+    static BlockHeader decodeHeader(const uint8_t *p)
+    {
+        BlockHeader h;
+        h.recordCount = static_cast<uint32_t>(getFixed(p, 4));
+        h.minTime = static_cast<int64_t>(getFixed(p + 4, 8));
+        h.maxTime = static_cast<int64_t>(getFixed(p + 12, 8));
+        h.payloadSize = static_cast<uint32_t>(getFixed(p + 20, 4));
+        return h;
+    }
+
+    // Decode payload satu blok, hasil ditambahkan ke 'out'. Mengembalikan false jika blok rusak.
+    static bool decodeBlock(const BlockHeader &header, const uint8_t *payload, std::vector<Transaction> &out)
+    {
+        Cursor c{payload, payload + header.payloadSize};
+        size_t n = header.recordCount;
+        if (n > BLOCK_RECORDS)
+            return false;
+
+        // Ukuran dari data yang belum divalidasi: setiap entri kamus minimal 1 byte, jadi ukuran yang melebihi
+        // sisa payload pasti rusak (dan tidak boleh dipakai untuk alokasi)
+        uint64_t dictSize = c.varint();
+        if (!c.valid || dictSize > static_cast<uint64_t>(c.end - c.p))
+            return false;
+        std::vector<Id> dict(dictSize);
+        for (auto &s : dict)
+            s = c.str();
+
+        std::vector<Id> ids(n);
+        if (c.varint() == 1)
+        {
+            std::string prefix = c.str();
+            int64_t prev = 0;
+            for (size_t i = 0; i < n; ++i)
+            {
+                prev += unzigzag(c.varint());
+                ids[i] = prefix + std::to_string(prev);
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < n; ++i)
+                ids[i] = c.str();
+        }
+
+        std::vector<uint64_t> cols(3 * n);
+        for (auto &v : cols)
+        {
+            v = c.varint();
+            if (v >= dict.size())
+                c.valid = false;
+        }
+        double scale = static_cast<double>(c.varint());
+        if (scale != 1.0 && scale != 100.0 && scale != AMOUNT_SCALE)
+            c.valid = false;
+        std::vector<double> amounts(n);
+        for (auto &a : amounts)
+            a = static_cast<double>(unzigzag(c.varint())) / scale;
+        std::vector<int> quantities(n);
+        for (auto &q : quantities)
+            q = static_cast<int>(unzigzag(c.varint()));
+        std::vector<time_t> dates(n);
+        int64_t prevTime = header.minTime;
+        for (auto &d : dates)
+        {
+            prevTime += unzigzag(c.varint());
+            d = static_cast<time_t>(prevTime);
+        }
+        std::vector<uint8_t> flags;
+        flags.reserve(n);
+        while (c.valid && flags.size() < n)
+        {
+            uint64_t run = c.varint();
+            if (c.p >= c.end || run == 0 || run > n - flags.size())
+            {
+                c.valid = false;
+                break;
+            }
+            flags.insert(flags.end(), run, *c.p++);
+        }
+        if (!c.valid)
+            return false;
+
+        out.reserve(out.size() + n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            out.emplace_back(ids[i], dict[cols[i]], dict[cols[n + i]], dict[cols[2 * n + i]],
+                             amounts[i], quantities[i], dates[i],
+                             static_cast<TransactionStatus>(flags[i] >> 4),
+                             static_cast<TransactionType>(flags[i] & 0x0F));
+        }
+        return true;
+    }
+
+    // Encode record (diurutkan waktu secara stabil agar min/max blok rapat) blok demi blok ke sink(bytes)
+    template <typename Sink>
+    static void encodeBlocks(std::vector<const Transaction *> records, Sink sink)
+    {
+        std::stable_sort(records.begin(), records.end(), [](const Transaction *a, const Transaction *b)
+                         { return a->getDate() < b->getDate(); });
+
+        sink(std::string("LDG1"));
+        std::vector<const Transaction *> block;
+        for (size_t start = 0; start < records.size(); start += BLOCK_RECORDS)
+        {
+            size_t end = std::min(records.size(), start + BLOCK_RECORDS);
+            block.assign(records.begin() + start, records.begin() + end);
+            sink(encodeBlock(block));
+        }
+    }
+
+    // Tulis seluruh transaksi ke file ledger
+    static bool writeFile(const std::string &path, std::vector<const Transaction *> records)
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open())
+            return false;
+        encodeBlocks(std::move(records), [&out](const std::string &bytes)
+                     { out.write(bytes.data(), static_cast<std::streamsize>(bytes.size())); });
+        out.close();
+        return !out.fail();
+    }
+
+    // Encode seluruh ledger ke memori (mis. untuk snapshot read replica di shared memory)
+    static std::string encode(std::vector<const Transaction *> records)
+    {
+        std::string bytes;
+        encodeBlocks(std::move(records), [&bytes](const std::string &block)
+                     { bytes += block; });
+        return bytes;
+    }
+};
+
+#endif // LEDGERFORMAT_H
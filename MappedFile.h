@@ -0,0 +1,55 @@
+// File: MappedFile.h
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <string>
+#include <string_view>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// File yang dipetakan ke memori (read-only). Isi file dibaca langsung lewat string_view tanpa salinan.
+class MappedFile
+{
+private:
+    const char *data = nullptr;
+    size_t length = 0;
+
+public:
+    explicit MappedFile(const std::string &path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return;
+
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            void *p = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED)
+            {
+                data = static_cast<const char *>(p);
+                length = static_cast<size_t>(st.st_size);
+                ::madvise(p, length, MADV_SEQUENTIAL); // Petunjuk ke kernel: baca berurutan (read-ahead)
+            }
+        }
+        ::close(fd); // Mapping tetap valid setelah fd ditutup
+    }
+
+    ~MappedFile()
+    {
+        if (data)
+            ::munmap(const_cast<char *>(data), length);
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool isOpen() const { return data != nullptr; }
+    size_t size() const { return length; }
+    std::string_view view() const { return std::string_view(data, length); }
+};
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,113 @@
+// File: MemoryFootprint.h
+
+#ifndef MEMORYFOOTPRINT_H
+#define MEMORYFOOTPRINT_H
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Perkiraan pemakaian RAM per struktur data (tanpa mengganti allocator container).
+// Setiap alokasi heap dihitung seperti malloc glibc 64-bit: header 8 byte, dibulatkan ke 16, minimal 32.
+// Node std::map/std::set = header red-black tree (32 byte) + nilai; node unordered_map = pointer next +
+// nilai + hash tersimpan, ditambah array bucket. String pendek (SSO) tidak memakai heap.
+class MemoryFootprint
+{
+public:
+    struct Usage
+    {
+        std::string structure;
+        size_t elements = 0;
+        size_t bytes = 0;
+
+        double bytesPerElement() const { return elements ? static_cast<double>(bytes) / elements : 0.0; }
+    };
+    using Report = std::vector<Usage>;
+
+    static size_t allocation(size_t size)
+    {
+        if (size == 0)
+            return 0;
+        return std::max<size_t>(32, (size + 8 + 15) & ~static_cast<size_t>(15));
+    }
+
+    // Byte heap milik string (0 jika masih di buffer SSO di dalam objek)
+    static size_t heap(const std::string &s)
+    {
+        const char *self = reinterpret_cast<const char *>(&s);
+        bool inlined = s.data() >= self && s.data() < self + sizeof(s);
+        return inlined ? 0 : allocation(s.capacity() + 1);
+    }
+
+    template <typename T>
+    static size_t buffer(const std::vector<T> &v)
+    {
+        return allocation(v.capacity() * sizeof(T));
+    }
+
+    static size_t heap(const std::vector<std::string> &v)
+    {
+        size_t bytes = buffer(v);
+        for (const auto &s : v)
+            bytes += heap(s);
+        return bytes;
+    }
+
+    template <typename Value>
+    static size_t treeNode()
+    {
+        return allocation(32 + sizeof(Value));
+    }
+
+    template <typename Value>
+    static size_t hashNode()
+    {
+        return allocation(sizeof(void *) + sizeof(Value) + sizeof(size_t));
+    }
+
+    template <typename HashMap>
+    static size_t buckets(const HashMap &map)
+    {
+        return allocation(map.bucket_count() * sizeof(void *));
+    }
+
+    // Objek yang dibuat lewat std::make_shared: objek + control block dalam satu alokasi
+    template <typename T>
+    static size_t shared()
+    {
+        return allocation(sizeof(T) + 16);
+    }
+
+    static void display(const Report &report)
+    {
+        std::cout << "\n--- Pemakaian Memori per Struktur (perkiraan) ---" << std::endl;
+        size_t total = 0;
+        for (const Usage &usage : report)
+        {
+            std::cout << std::left << std::setw(28) << usage.structure << std::right
+                      << " | elemen: " << std::setw(10) << usage.elements
+                      << " | " << std::setw(10) << std::fixed << std::setprecision(1) << usage.bytes / 1024.0 << " KiB"
+                      << " | byte/elemen: " << std::setw(8) << usage.bytesPerElement() << std::endl;
+            std::cout.unsetf(std::ios::fixed);
+            std::cout << std::setprecision(6);
+            total += usage.bytes;
+        }
+        std::cout << "Total: " << total / 1024.0 / 1024.0 << " MiB" << std::endl;
+    }
+
+    // Format mesin (CSV) untuk dilacak antar versi
+    static std::string toCsv(const Report &report)
+    {
+        std::ostringstream out;
+        out << "structure,elements,bytes,bytes_per_element\n";
+        for (const Usage &usage : report)
+            out << usage.structure << "," << usage.elements << "," << usage.bytes << ","
+                << std::fixed << std::setprecision(2) << usage.bytesPerElement() << "\n";
+        return out.str();
+    }
+};
+
+#endif // MEMORYFOOTPRINT_H
@@ -0,0 +1,301 @@
+// File: Metrics.h
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <algorithm>
+#include <atomic>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Instrumentasi ringan untuk operasi Store & Bank: counter, histogram latensi, dan gauge.
+// Counter & histogram dipecah per "shard" yang dipilih per thread, sehingga thread yang berbeda
+// hampir tidak pernah menulis ke cache line yang sama.
+class Metrics
+{
+public:
+    static constexpr size_t SHARDS = 8;
+
+    // Index shard untuk thread saat ini (dihitung sekali per thread)
+    static size_t shardIndex()
+    {
+        thread_local size_t index = std::hash<std::thread::id>()(std::this_thread::get_id()) % SHARDS;
+        return index;
+    }
+
+    class Counter
+    {
+    private:
+        struct alignas(64) Slot
+        {
+            std::atomic<uint64_t> value{0};
+        };
+        std::array<Slot, SHARDS> slots;
+
+    public:
+        void increment(uint64_t n = 1) { slots[shardIndex()].value.fetch_add(n, std::memory_order_relaxed); }
+
+        uint64_t value() const
+        {
+            uint64_t total = 0;
+            for (const auto &slot : slots)
+                total += slot.value.load(std::memory_order_relaxed);
+            return total;
+        }
+    };
+
+    // Histogram log-linear ala HDR: setiap pangkat dua dibagi 16 sub-bucket (error relatif <= 6.25%).
+    // Nilai dicatat dalam nanodetik.
+    class Histogram
+    {
+    public:
+        static constexpr int SUB_BITS = 4;
+        static constexpr int SUB_BUCKETS = 1 << SUB_BITS;
+        static constexpr int EXPONENTS = 48; // Sampai ~2^48 ns (~3 hari)
+        static constexpr int BUCKETS = EXPONENTS * SUB_BUCKETS;
+
+    private:
+        struct alignas(64) Shard
+        {
+            std::array<std::atomic<uint64_t>, BUCKETS> buckets{};
+            std::atomic<uint64_t> count{0};
+            std::atomic<uint64_t> sum{0};
+            std::atomic<uint64_t> max{0};
+        };
+        std::array<Shard, SHARDS> shards;
+
+    public:
+        static int bucketOf(uint64_t v)
+        {
+            if (v < SUB_BUCKETS)
+                return static_cast<int>(v);
+            int exponent = 63 - __builtin_clzll(v); // Posisi bit tertinggi
+            int sub = static_cast<int>((v >> (exponent - SUB_BITS)) & (SUB_BUCKETS - 1));
+            int index = (exponent - SUB_BITS + 1) * SUB_BUCKETS + sub;
+            return index < BUCKETS ? index : BUCKETS - 1;
+        }
+
+        // Batas atas (eksklusif) bucket dalam nanodetik
+        static uint64_t upperBound(int index)
+        {
+            if (index < SUB_BUCKETS)
+                return static_cast<uint64_t>(index) + 1;
+            int exponent = index / SUB_BUCKETS + SUB_BITS - 1;
+            uint64_t sub = static_cast<uint64_t>(index % SUB_BUCKETS);
+            return (1ULL << exponent) + ((sub + 1) << (exponent - SUB_BITS));
+        }
+
+        void record(uint64_t nanos)
+        {
+            Shard &shard = shards[shardIndex()];
+            shard.buckets[bucketOf(nanos)].fetch_add(1, std::memory_order_relaxed);
+            shard.count.fetch_add(1, std::memory_order_relaxed);
+            shard.sum.fetch_add(nanos, std::memory_order_relaxed);
+            uint64_t prev = shard.max.load(std::memory_order_relaxed);
+            while (nanos > prev && !shard.max.compare_exchange_weak(prev, nanos, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        // Gabungkan semua shard (dipanggil saat membaca, bukan di jalur panas)
+        void collect(std::vector<uint64_t> &buckets, uint64_t &count, uint64_t &sum, uint64_t &max) const
+        {
+            buckets.assign(BUCKETS, 0);
+            count = sum = max = 0;
+            for (const auto &shard : shards)
+            {
+                for (int i = 0; i < BUCKETS; ++i)
+                    buckets[i] += shard.buckets[i].load(std::memory_order_relaxed);
+                count += shard.count.load(std::memory_order_relaxed);
+                sum += shard.sum.load(std::memory_order_relaxed);
+                max = std::max(max, shard.max.load(std::memory_order_relaxed));
+            }
+        }
+
+        static uint64_t percentile(const std::vector<uint64_t> &buckets, uint64_t count, double p)
+        {
+            if (count == 0)
+                return 0;
+            uint64_t target = static_cast<uint64_t>(p * static_cast<double>(count - 1)) + 1;
+            uint64_t seen = 0;
+            for (int i = 0; i < BUCKETS; ++i)
+            {
+                seen += buckets[i];
+                if (seen >= target)
+                    return upperBound(i);
+            }
+            return upperBound(BUCKETS - 1);
+        }
+    };
+
+    // Catat durasi sebuah scope ke histogram (RAII)
+    class ScopedTimer
+    {
+    private:
+        Histogram &histogram;
+        std::chrono::steady_clock::time_point start;
+
+    public:
+        explicit ScopedTimer(Histogram &h) : histogram(h), start(std::chrono::steady_clock::now()) {}
+        ~ScopedTimer()
+        {
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            histogram.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+        ScopedTimer(const ScopedTimer &) = delete;
+        ScopedTimer &operator=(const ScopedTimer &) = delete;
+    };
+
+private:
+    struct Family
+    {
+        std::string help;
+        std::string type; // counter / histogram / gauge
+    };
+
+    std::mutex mtx; // Hanya untuk registrasi & export, bukan jalur pencatatan
+    std::map<std::string, Family> families;
+    std::map<std::pair<std::string, std::string>, std::unique_ptr<Counter>> counters;     // (nama, label) -> Counter
+    std::map<std::pair<std::string, std::string>, std::unique_ptr<Histogram>> histograms; // (nama, label) -> Histogram
+    std::map<std::pair<std::string, std::string>, std::function<double()>> gauges;       // (nama, label) -> pembaca nilai
+
+    // Konsep Singleton
+    Metrics() = default;
+    Metrics(const Metrics &) = delete;
+    Metrics &operator=(const Metrics &) = delete;
+
+    static std::string formatLabels(const std::string &labels, const std::string &extra = "")
+    {
+        std::string all = labels;
+        if (!extra.empty())
+            all += (all.empty() ? "" : ",") + extra;
+        return all.empty() ? "" : "{" + all + "}";
+    }
+
+public:
+    static Metrics &getInstance()
+    {
+        static Metrics instance;
+        return instance;
+    }
+
+    // Registrasi mengembalikan referensi yang stabil; simpan di variabel static pada titik instrumentasi.
+    // labels ditulis dalam format Prometheus, mis. "reason=\"stock\"".
+    Counter &counter(const std::string &name, const std::string &help, const std::string &labels = "")
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        families.emplace(name, Family{help, "counter"});
+        auto &slot = counters[{name, labels}];
+        if (!slot)
+            slot = std::make_unique<Counter>();
+        return *slot;
+    }
+
+    Histogram &histogram(const std::string &name, const std::string &help, const std::string &labels = "")
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        families.emplace(name, Family{help, "histogram"});
+        auto &slot = histograms[{name, labels}];
+        if (!slot)
+            slot = std::make_unique<Histogram>();
+        return *slot;
+    }
+
+    // Gauge dibaca saat export (mis. ukuran map), sehingga tidak ada biaya di jalur operasi
+    void gauge(const std::string &name, const std::string &help, std::function<double()> reader, const std::string &labels = "")
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        families.emplace(name, Family{help, "gauge"});
+        gauges[{name, labels}] = std::move(reader);
+    }
+
+    // Format eksposisi teks Prometheus
+    std::string toPrometheus()
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        std::ostringstream out;
+        out << std::setprecision(9);
+        std::vector<uint64_t> buckets;
+        for (const auto &family : families)
+        {
+            const std::string &name = family.first;
+            out << "# HELP " << name << " " << family.second.help << "\n";
+            out << "# TYPE " << name << " " << family.second.type << "\n";
+
+            for (auto it = counters.lower_bound({name, ""}); it != counters.end() && it->first.first == name; ++it)
+                out << name << formatLabels(it->first.second) << " " << it->second->value() << "\n";
+
+            for (auto it = gauges.lower_bound({name, ""}); it != gauges.end() && it->first.first == name; ++it)
+                out << name << formatLabels(it->first.second) << " " << it->second() << "\n";
+
+            for (auto it = histograms.lower_bound({name, ""}); it != histograms.end() && it->first.first == name; ++it)
+            {
+                uint64_t count, sum, max;
+                it->second->collect(buckets, count, sum, max);
+                // Bucket kumulatif per pangkat dua (cukup untuk scraper, detail sub-bucket tetap di memori)
+                uint64_t cumulative = 0;
+                for (int i = 0; i < Histogram::BUCKETS; ++i)
+                {
+                    cumulative += buckets[i];
+                    bool boundary = (i + 1) % Histogram::SUB_BUCKETS == 0;
+                    if (boundary && cumulative > 0)
+                    {
+                        double le = static_cast<double>(Histogram::upperBound(i)) / 1e9;
+                        std::ostringstream bound;
+                        bound << std::setprecision(9) << le;
+                        out << name << "_bucket" << formatLabels(it->first.second, "le=\"" + bound.str() + "\"") << " " << cumulative << "\n";
+                    }
+                    if (cumulative == count && boundary)
+                        break;
+                }
+                out << name << "_bucket" << formatLabels(it->first.second, "le=\"+Inf\"") << " " << count << "\n";
+                out << name << "_sum" << formatLabels(it->first.second) << " " << static_cast<double>(sum) / 1e9 << "\n";
+                out << name << "_count" << formatLabels(it->first.second) << " " << count << "\n";
+            }
+        }
+        return out.str();
+    }
+
+    // Ringkasan untuk menu management
+    void display()
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        std::cout << "\n--- Metrics: Latensi (mikrodetik) ---" << std::endl;
+        std::vector<uint64_t> buckets;
+        for (const auto &pair : histograms)
+        {
+            uint64_t count, sum, max;
+            pair.second->collect(buckets, count, sum, max);
+            std::cout << pair.first.first << formatLabels(pair.first.second)
+                      << " | n: " << count
+                      << " | p50: " << std::min(Histogram::percentile(buckets, count, 0.50), max) / 1000.0
+                      << " | p99: " << std::min(Histogram::percentile(buckets, count, 0.99), max) / 1000.0
+                      << " | max: " << max / 1000.0 << std::endl;
+        }
+
+        std::cout << "\n--- Metrics: Counter ---" << std::endl;
+        for (const auto &pair : counters)
+        {
+            std::cout << pair.first.first << formatLabels(pair.first.second) << " = " << pair.second->value() << std::endl;
+        }
+
+        std::cout << "\n--- Metrics: Gauge ---" << std::endl;
+        for (const auto &pair : gauges)
+        {
+            std::cout << pair.first.first << formatLabels(pair.first.second) << " = " << pair.second() << std::endl;
+        }
+    }
+};
+
+#endif // METRICS_H
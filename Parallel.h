@@ -0,0 +1,59 @@
+// File: Parallel.h
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Utilitas eksekusi paralel untuk loader dan laporan yang memindai seluruh ledger
+class Parallel
+{
+public:
+    static size_t workerCount()
+    {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Jalankan task 0..taskCount-1 di semua core (task dibagi dinamis lewat counter atomik)
+    template <typename Fn>
+    static void run(size_t taskCount, Fn fn)
+    {
+        size_t threadCount = std::min(taskCount, workerCount());
+        if (threadCount <= 1)
+        {
+            for (size_t i = 0; i < taskCount; ++i)
+                fn(i);
+            return;
+        }
+
+        std::atomic<size_t> next(0);
+        std::vector<std::thread> workers;
+        for (size_t w = 0; w < threadCount; ++w)
+        {
+            workers.emplace_back([&]()
+                                 {
+                for (size_t i = next++; i < taskCount; i = next++)
+                    fn(i); });
+        }
+        for (auto &worker : workers)
+            worker.join();
+    }
+
+    // Bagi [0, n) menjadi rentang berurutan dan proses tiap rentang ke hasil lokalnya sendiri:
+    // fn(begin, end, T &local). Hasil dikembalikan sesuai urutan rentang sehingga penggabungan
+    // berurutan memberi hasil yang sama dengan versi serial. Data kecil diproses dalam satu rentang.
+    template <typename T, typename Fn>
+    static std::vector<T> mapRanges(size_t n, Fn fn, size_t minPerRange = 16384)
+    {
+        size_t ranges = std::max<size_t>(1, std::min(n / std::max<size_t>(minPerRange, 1), 4 * workerCount()));
+        std::vector<T> results(ranges);
+        run(ranges, [&](size_t r)
+            { fn(n * r / ranges, n * (r + 1) / ranges, results[r]); });
+        return results;
+    }
+};
+
+#endif // PARALLEL_H
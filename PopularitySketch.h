@@ -0,0 +1,210 @@
+// File: PopularitySketch.h
+
+#ifndef POPULARITYSKETCH_H
+#define POPULARITYSKETCH_H
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "DayRing.h"
+#include "Id.h"
+
+// Sketch heavy-hitter Space-Saving dengan kapasitas tetap.
+// Setiap counter menyimpan estimasi (batas atas) dan error; jumlah sebenarnya berada di [count - error, count].
+// Item yang frekuensinya > total / capacity dijamin tercatat.
+class SpaceSaving
+{
+public:
+    struct Counter
+    {
+        Id key;
+        uint64_t count = 0;
+        uint64_t error = 0;
+    };
+
+private:
+    size_t capacity;
+    uint64_t total = 0;
+    std::vector<Counter> counters;
+    std::unordered_map<Id, size_t> index; // Key -> posisi di counters
+
+    size_t minPosition() const
+    {
+        size_t pos = 0;
+        for (size_t i = 1; i < counters.size(); ++i)
+        {
+            if (counters[i].count < counters[pos].count)
+                pos = i;
+        }
+        return pos;
+    }
+
+    // Estimasi minimum untuk key yang tidak tercatat (0 jika sketch belum penuh)
+    uint64_t floorCount() const
+    {
+        return counters.size() < capacity || counters.empty() ? 0 : counters[minPosition()].count;
+    }
+
+public:
+    explicit SpaceSaving(size_t cap = 32) : capacity(cap) {}
+
+    void add(const Id &key, uint64_t weight = 1)
+    {
+        total += weight;
+        auto it = index.find(key);
+        if (it != index.end())
+        {
+            counters[it->second].count += weight;
+            return;
+        }
+        if (counters.size() < capacity)
+        {
+            index.emplace(key, counters.size());
+            counters.push_back({key, weight, 0});
+            return;
+        }
+        // Gantikan counter terkecil: key baru mewarisi hitungannya sebagai error
+        size_t pos = minPosition();
+        Counter &victim = counters[pos];
+        index.erase(victim.key);
+        victim.error = victim.count;
+        victim.count += weight;
+        victim.key = key;
+        index.emplace(key, pos);
+    }
+
+    // Kurangi hitungan (mis. pesanan dibatalkan). Key yang sudah tergusur diabaikan.
+    void remove(const Id &key, uint64_t weight = 1)
+    {
+        total -= std::min(total, weight);
+        auto it = index.find(key);
+        if (it == index.end())
+            return;
+        Counter &counter = counters[it->second];
+        counter.count -= std::min(counter.count, weight);
+        counter.error = std::min(counter.error, counter.count);
+    }
+
+    // Gabungkan sketch lain (mergeable summaries): key yang tidak tercatat di salah satu sketch
+    // dianggap bernilai estimasi minimum sketch tersebut, lalu disisakan capacity counter terbesar.
+    void merge(const SpaceSaving &other)
+    {
+        uint64_t floorA = floorCount(), floorB = other.floorCount();
+        std::unordered_map<Id, Counter> combined;
+        for (const Counter &c : counters)
+            combined[c.key] = {c.key, c.count + floorB, c.error + floorB};
+        for (const Counter &c : other.counters)
+        {
+            auto it = combined.find(c.key);
+            if (it != combined.end())
+            {
+                it->second.count += c.count - floorB;
+                it->second.error += c.error - floorB;
+            }
+            else
+            {
+                combined[c.key] = {c.key, c.count + floorA, c.error + floorA};
+            }
+        }
+
+        counters.clear();
+        for (auto &pair : combined)
+            counters.push_back(std::move(pair.second));
+        std::sort(counters.begin(), counters.end(), [](const Counter &a, const Counter &b)
+                  { return a.count != b.count ? a.count > b.count : a.key < b.key; });
+        if (counters.size() > capacity)
+            counters.resize(capacity);
+        index.clear();
+        for (size_t i = 0; i < counters.size(); ++i)
+            index.emplace(counters[i].key, i);
+        total += other.total;
+    }
+
+    // k counter terbesar, urut estimasi menurun (seri diurutkan per key)
+    std::vector<Counter> top(size_t k) const
+    {
+        std::vector<Counter> result(counters);
+        std::sort(result.begin(), result.end(), [](const Counter &a, const Counter &b)
+                  { return a.count != b.count ? a.count > b.count : a.key < b.key; });
+        if (result.size() > k)
+            result.resize(k);
+        return result;
+    }
+
+    uint64_t getTotal() const { return total; }
+    size_t getCapacity() const { return capacity; }
+
+    void clear()
+    {
+        total = 0;
+        counters.clear();
+        index.clear();
+    }
+};
+
+// Popularitas item yang diperbarui per pembelian dengan memori tetap:
+// - store-wide sepanjang waktu (jumlah transaksi per item, untuk listMostFrequentItems)
+// - per seller dalam ring harian WINDOW_DAYS hari (jumlah unit terjual, untuk discoverPopularItems).
+// Sketch harian seluruh seller dapat digabung menjadi tampilan store-wide untuk jendela yang sama.
+class PopularityTracker
+{
+public:
+    static constexpr int WINDOW_DAYS = 31; // Jendela "sebulan" (30 hari) + hari berjalan
+    static constexpr size_t CAPACITY = 64;
+
+private:
+    using SellerRing = DayRing<SpaceSaving, WINDOW_DAYS>;
+
+    SpaceSaving allTime{CAPACITY};
+    std::unordered_map<Id, SellerRing> sellers; // SellerId -> ring harian
+
+public:
+    void record(const Id &sellerId, const Id &itemId, int quantity, time_t date)
+    {
+        allTime.add(itemId);
+        auto it = sellers.try_emplace(sellerId, SpaceSaving(CAPACITY)).first;
+        if (SpaceSaving *day = it->second.slotFor(date, true))
+            day->add(itemId, static_cast<uint64_t>(quantity));
+    }
+
+    void unrecord(const Id &sellerId, const Id &itemId, int quantity, time_t date)
+    {
+        allTime.remove(itemId);
+        auto it = sellers.find(sellerId);
+        SpaceSaving *day = it == sellers.end() ? nullptr : it->second.slotFor(date, false);
+        if (day)
+            day->remove(itemId, static_cast<uint64_t>(quantity));
+    }
+
+    const SpaceSaving &storeAllTime() const { return allTime; }
+
+    // Unit terjual per item milik seller sejak hari dari waktu 'since'
+    SpaceSaving sellerWindow(const Id &sellerId, time_t since) const
+    {
+        SpaceSaving result(CAPACITY);
+        auto it = sellers.find(sellerId);
+        if (it != sellers.end())
+            it->second.forEachSince(since, [&](const SpaceSaving &day)
+                                    { result.merge(day); });
+        return result;
+    }
+
+    // Gabungan seluruh seller untuk jendela yang sama
+    SpaceSaving storeWindow(time_t since) const
+    {
+        SpaceSaving result(CAPACITY);
+        for (const auto &pair : sellers)
+            pair.second.forEachSince(since, [&](const SpaceSaving &day)
+                                     { result.merge(day); });
+        return result;
+    }
+
+    void clear()
+    {
+        allTime.clear();
+        sellers.clear();
+    }
+};
+
+#endif // POPULARITYSKETCH_H
@@ -4,44 +4,94 @@
 #define SELLER_H
 
 #include <map>
+#include <set>
+#include <iostream>
 #include "Buyer.h"
 #include "Item.h"
+#include "Journal.h"
 
 class Seller : public Buyer {
 private:
-    std::map<std::string, Item> items; // Seller manage stock items [cite: 7]
+    std::map<Id, Item> items; // Seller manage stock items [cite: 7]
+    uint64_t catalogVersion = 0;       // Naik setiap ada item yang berubah
+
+    // Watch list stok menipis: item dengan stok <= threshold, stok terkecil di depan.
+    // Diperbarui setiap stok berubah sehingga daftar alert tidak perlu scan seluruh katalog.
+    int lowStockThreshold = DEFAULT_LOW_STOCK_THRESHOLD;
+    std::set<std::pair<int, Id>> lowStockQueue; // (Stok, ItemId)
+    std::map<Id, int> lowStockLevel;                // ItemId -> stok yang tercatat di lowStockQueue
+
+    void refreshLowStock(const Id& itemId) {
+        auto it = lowStockLevel.find(itemId);
+        if (it != lowStockLevel.end()) {
+            lowStockQueue.erase({it->second, itemId});
+            lowStockLevel.erase(it);
+        }
+        Item* item = getItem(itemId);
+        if (item && item->getStock() <= lowStockThreshold) {
+            lowStockQueue.emplace(item->getStock(), itemId);
+            lowStockLevel[itemId] = item->getStock();
+        }
+    }
 
 public:
-    Seller(const std::string& id, const std::string& user, const std::string& pass)
+    static constexpr int DEFAULT_LOW_STOCK_THRESHOLD = 5;
+
+    Seller(const Id& id, const std::string& user, const std::string& pass)
         : Buyer(id, user, pass) {}
 
     // Manajemen Item [cite: 43]
-    void registerNewItem(const std::string& itemId, const std::string& name, double price, int stock) { // Register new item [cite: 44]
+    void registerNewItem(const Id& itemId, const std::string& name, double price, int stock) { // Register new item [cite: 44]
         items.emplace(itemId, Item(itemId, name, price, stock));
+        Journal::getInstance().advance();
+        touchItem(itemId);
         // Set price per item [cite: 46] dilakukan saat registrasi
     }
 
-    Item* getItem(const std::string& itemId) {
-        if (items.count(itemId)) {
+    // Pulihkan item dari file (tanpa mencatat perubahan ke journal / dirty tracking)
+    void restoreItem(const Item& item) {
+        auto res = items.emplace(item.getId(), item);
+        if (!res.second) {
+            res.first->second = item;
+        }
+        refreshLowStock(item.getId());
+    }
+
+    // Pindahkan seluruh item dari objek seller lama (digunakan saat data seller diperbarui dari checkpoint)
+    void takeItemsFrom(Seller& other) {
+        items.swap(other.items);
+        catalogVersion = other.catalogVersion;
+        lowStockThreshold = other.lowStockThreshold;
+        lowStockQueue.swap(other.lowStockQueue);
+        lowStockLevel.swap(other.lowStockLevel);
+    }
+
+    Item* getItem(const Id& itemId) {
+        if (itemId.valid() && items.count(itemId)) {
             return &items.at(itemId);
         }
         return nullptr;
     }
     
     // Item can be replenished, discarded [cite: 45]
-    bool replenishStock(const std::string& itemId, int quantity) {
+    bool replenishStock(const Id& itemId, int quantity) {
         Item* item = getItem(itemId);
         if (item) {
-            item->setStock(item->getStock() + quantity);
+            item->addStock(quantity);
+            Journal::getInstance().advance();
+            touchItem(itemId);
             return true;
         }
         return false;
     }
 
-    bool discardStock(const std::string& itemId, int quantity) {
+    bool discardStock(const Id& itemId, int quantity) {
         Item* item = getItem(itemId);
-        if (item && item->getStock() >= quantity) {
-            item->setStock(item->getStock() - quantity);
+        // Reservasi + commit langsung agar pengecekan dan pengurangan stok terjadi atomik
+        if (item && item->reserveStock(quantity)) {
+            item->commitReservation(quantity);
+            Journal::getInstance().advance();
+            touchItem(itemId);
             if (item->getStock() == 0) {
                 // Opsional: Hapus item jika stok nol
                 // items.erase(itemId); 
@@ -51,15 +101,90 @@ public:
         return false;
     }
 
+    // Tandai item berubah (dipanggil juga oleh Store saat stok berubah karena pembelian/refund)
+    void touchItem(const Id& itemId) {
+        catalogVersion++;
+        ChangeTracker::getInstance().markItem(userId, itemId);
+        refreshLowStock(itemId);
+    }
+
+    // --- Watch List Stok Menipis ---
+
+    int getLowStockThreshold() const {
+        return lowStockThreshold;
+    }
+
+    // Ubah threshold lalu bangun ulang watch list (satu-satunya operasi yang perlu scan katalog)
+    void setLowStockThreshold(int threshold) {
+        lowStockThreshold = threshold;
+        lowStockQueue.clear();
+        lowStockLevel.clear();
+        for (const auto& pair : items) {
+            refreshLowStock(pair.first);
+        }
+    }
+
+    const std::set<std::pair<int, Id>>& getLowStockItems() const {
+        return lowStockQueue;
+    }
+
+    // Tampilkan item berisiko habis, stok terkecil lebih dulu. Biaya O(jumlah alert).
+    void displayLowStock() const {
+        std::cout << "\n--- Item dengan Stok <= " << lowStockThreshold << " ---" << std::endl;
+        if (lowStockQueue.empty()) {
+            std::cout << "Semua item memiliki stok aman." << std::endl;
+            return;
+        }
+        for (const auto& entry : lowStockQueue) {
+            const Item& item = items.at(entry.second);
+            std::cout << "Item ID: " << entry.second
+                      << " | Nama: " << item.getName()
+                      << " | Stok: " << entry.first
+                      << (entry.first == 0 ? " (HABIS)" : "") << std::endl;
+        }
+    }
+
+    uint64_t getCatalogVersion() const {
+        return catalogVersion;
+    }
+
     // Getter untuk semua item
-    const std::map<std::string, Item>& getAllItems() const {
+    const std::map<Id, Item>& getAllItems() const {
         return items;
     }
 
+    std::shared_ptr<User> clone() const override {
+        return std::make_shared<Seller>(*this);
+    }
+
+    // Tanpa katalog item (dihitung terpisah lewat itemMemoryBytes)
+    size_t memoryBytes() const override {
+        size_t bytes = MemoryFootprint::shared<Seller>() + stringHeapBytes() + MemoryFootprint::buffer(getOrderIds());
+        bytes += lowStockQueue.size() * MemoryFootprint::treeNode<std::pair<int, Id>>();
+        bytes += lowStockLevel.size() * MemoryFootprint::treeNode<std::pair<const Id, int>>();
+        return bytes;
+    }
+
+    size_t itemMemoryBytes() const {
+        size_t bytes = 0;
+        for (const auto& pair : items)
+            bytes += MemoryFootprint::treeNode<std::pair<const Id, Item>>() + pair.second.heapBytes();
+        return bytes;
+    }
+
+    // Bagian data seller tanpa item (untuk checkpoint inkremental, item ditulis per record)
+    // Format: SELLER,ID,Username,Password,Order1_ID|...|
+    std::string toHeaderString() const {
+        std::string base = Buyer::toString();
+        // Ganti 'BUYER' di base string menjadi 'SELLER'
+        base.replace(0, 5, "SELLER");
+        return base + "|";
+    }
+
     // Implementasi toString untuk serialisasi
     std::string toString() const override {
         // Format: SELLER,ID,Username,Password,Order1_ID|...| , Item1|Item2|...
-        std::string base = Buyer::toString();
+        std::string base = toHeaderString();
         
         // Tambahkan item yang dimiliki
         std::string itemList;
@@ -71,9 +196,7 @@ public:
             itemList.pop_back(); // Hapus ";" terakhir
         }
 
-        // Ganti 'BUYER' di base string menjadi 'SELLER'
-        base.replace(0, 5, "SELLER");
-        return base + "|" + itemList;
+        return base + itemList;
     }
 };
 
@@ -0,0 +1,956 @@
+// File: Server.h
+
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <unordered_map>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "Store.h"
+#include "DataPersistence.h"
+#include "Metrics.h"
+#include "Parallel.h"
+#include "ShardEngine.h"
+
+// Mode server: satu proses melayani banyak client lewat socket TCP localhost atau Unix socket.
+// Satu thread event loop (epoll) menangani accept/baca/tulis non-blocking; perintah dijalankan
+// oleh worker pool. Store & Bank belum thread-safe, jadi eksekusi perintah diserialisasi oleh
+// satu engine lock; parsing, format respons, dan I/O jaringan tetap berjalan paralel.
+// Dengan --shards N, BALANCE/TOPUP/WITHDRAW/PURCHASE dijalankan di thread shard milik user
+// (lihat ShardEngine.h) dan perintah lain berjalan exclusive menggantikan engine lock.
+// Dengan --publish <nama>, snapshot diterbitkan berkala ke shared memory (lihat SharedSnapshot.h);
+// proses lain dengan --replica <nama> memuatnya dan hanya melayani perintah baca (REPORT, BALANCE),
+// sehingga laporan berat tidak memakai engine lock primary.
+//
+// Protokol berbasis baris (token dipisah spasi, username/password tanpa spasi):
+//   PING | QUIT
+//   REGISTER BUYER|SELLER <username> <password>
+//   LOGIN <username> <password> | LOGOUT | BALANCE
+//   TOPUP <jumlah> | WITHDRAW <jumlah> | PURCHASE <itemId> <qty>   (opsional diakhiri key=<id>)
+//   REPORT <nama> [arg]  (lihat runReport; di replica diawali baris status snapshot, REPORT LAG hanya status)
+// Respons: "OK <n>" atau "ERR <n>" diikuti n baris isi (output yang biasanya dicetak ke konsol).
+// Perintah dari satu koneksi dijalankan berurutan; session (user yang login) disimpan per koneksi.
+class Server
+{
+public:
+    static constexpr size_t MAX_LINE = 4096;          // Baris lebih panjang dari ini = client salah protokol
+    static constexpr size_t MAX_PENDING = 1024;       // Batas perintah antre per koneksi
+    static constexpr int CHECKPOINT_INTERVAL_SEC = 5; // Checkpoint inkremental berkala
+    static constexpr int PUBLISH_INTERVAL_SEC = 5;    // Penerbitan snapshot replica berkala
+
+private:
+    struct Session
+    {
+        UserPtr user; // nullptr = belum login
+    };
+
+    struct Connection
+    {
+        int fd;
+        std::string input;               // Data masuk yang belum membentuk baris lengkap
+        std::string output;              // Respons yang belum terkirim
+        std::deque<std::string> pending; // Perintah yang menunggu giliran
+        bool busy = false;               // Ada perintah yang sedang dijalankan worker
+        bool closing = false;            // Tutup setelah output terkirim (QUIT / pelanggaran protokol)
+        bool closed = false;             // Sudah ditutup oleh event loop
+        bool writeArmed = false;         // EPOLLOUT sedang didaftarkan
+        Session session;                 // Hanya disentuh worker saat busy
+
+        explicit Connection(int f) : fd(f) {}
+    };
+    using ConnectionPtr = std::shared_ptr<Connection>;
+
+    // Pekerjaan berkala dari event loop (Job tanpa koneksi)
+    enum class Maintenance
+    {
+        CHECKPOINT, // Checkpoint inkremental ke disk
+        PUBLISH,    // Terbitkan snapshot untuk replica
+        REFRESH     // Replica: muat generasi snapshot terbaru jika ada
+    };
+
+    struct Job
+    {
+        ConnectionPtr connection; // nullptr = pekerjaan berkala (maintenance)
+        std::string line;
+        Maintenance maintenance = Maintenance::CHECKPOINT;
+    };
+
+    struct Completion
+    {
+        ConnectionPtr connection;
+        std::string response;
+        bool quit;
+    };
+
+    int epollFd = -1, listenFd = -1, wakeFd = -1, signalFd = -1;
+    std::string unixPath; // Dihapus saat server berhenti
+    std::unordered_map<int, ConnectionPtr> connections; // Hanya diakses event loop
+
+    std::mutex jobMtx;
+    std::condition_variable jobCv;
+    std::deque<Job> jobs;
+    bool stopping = false;
+
+    std::mutex completionMtx;
+    std::vector<Completion> completions;
+    std::vector<std::thread> workers;
+
+    // Store, Bank, dan std::cout (yang dialihkan per perintah) hanya dipakai satu thread dalam satu waktu
+    std::mutex engineMtx;
+    size_t shardCount = 0;
+    std::unique_ptr<ShardEngine> shards; // nullptr = tanpa shard (semua perintah lewat engine lock)
+
+    // Read replica. Publisher, pendingPublish, dan replica hanya disentuh di dalam exclusively
+    std::unique_ptr<SharedSnapshot::Publisher> publisher; // nullptr = tidak menerbitkan snapshot
+    std::future<bool> pendingPublish;                      // Serialisasi + penerbitan di background
+    ReplicaImage replicaImage;                             // Isi snapshot terakhir; hanya disentuh thread penerbitan
+    std::atomic<uint64_t> publishedJournal{UINT64_MAX};    // Posisi journal yang terakhir diterbitkan
+    std::unique_ptr<SharedSnapshot::Reader> replica;       // nullptr = bukan replica
+    uint64_t replicaJournal = 0;                           // Posisi journal snapshot yang dimuat replica
+    time_t replicaTakenAt = 0;                             // Waktu snapshot yang dimuat replica diambil
+    std::atomic<bool> refreshQueued{false};                // REFRESH sudah antre, jangan kirim lagi
+
+    // Jalankan fn sendirian terhadap Store & Bank: engine lock, atau semua shard dijeda
+    template <typename Fn>
+    void exclusively(Fn fn)
+    {
+        if (shards)
+        {
+            shards->exclusive(fn);
+            return;
+        }
+        std::lock_guard<std::mutex> lock(engineMtx);
+        fn();
+    }
+
+    // Alihkan std::cout ke buffer selama objek hidup (dipakai di bawah engine lock)
+    class CoutCapture
+    {
+    private:
+        std::ostringstream buffer;
+        std::streambuf *previous;
+
+    public:
+        CoutCapture() : previous(std::cout.rdbuf(buffer.rdbuf())) {}
+        ~CoutCapture() { std::cout.rdbuf(previous); }
+        std::string str() const { return buffer.str(); }
+    };
+
+    static std::vector<std::string_view> tokenize(std::string_view line)
+    {
+        std::vector<std::string_view> tokens;
+        size_t pos = 0;
+        while (pos < line.size())
+        {
+            size_t start = line.find_first_not_of(" \t", pos);
+            if (start == std::string_view::npos)
+                break;
+            size_t end = line.find_first_of(" \t", start);
+            if (end == std::string_view::npos)
+                end = line.size();
+            tokens.push_back(line.substr(start, end - start));
+            pos = end;
+        }
+        return tokens;
+    }
+
+    static std::string upper(std::string_view s)
+    {
+        std::string result(s);
+        std::transform(result.begin(), result.end(), result.begin(), [](unsigned char c)
+                       { return static_cast<char>(std::toupper(c)); });
+        return result;
+    }
+
+    template <typename T>
+    static bool parsePositive(std::string_view s, T &value)
+    {
+        auto res = std::from_chars(s.data(), s.data() + s.size(), value);
+        return res.ec == std::errc() && res.ptr == s.data() + s.size() && value > 0;
+    }
+
+    // TOPUP/WITHDRAW/PURCHASE boleh diakhiri "key=<id>" (idempotency key dari client). Token itu dilepas
+    // dari args dan nilainya dikembalikan; string kosong jika tidak ada.
+    static std::string takeIdempotencyKey(std::vector<std::string_view> &args)
+    {
+        if (args.size() < 2 || upper(args.back().substr(0, 4)) != "KEY=")
+            return std::string();
+        std::string key(args.back().substr(4));
+        args.pop_back();
+        return key;
+    }
+
+    // Bingkai respons: status + jumlah baris, lalu isi (baris kosong di output dibuang)
+    static std::string frame(bool ok, const std::string &body)
+    {
+        std::vector<std::string_view> lines;
+        std::string_view rest(body);
+        while (!rest.empty())
+        {
+            size_t newline = rest.find('\n');
+            std::string_view line = rest.substr(0, newline);
+            if (!line.empty())
+                lines.push_back(line);
+            rest = newline == std::string_view::npos ? std::string_view() : rest.substr(newline + 1);
+        }
+        std::string out = (ok ? "OK " : "ERR ") + std::to_string(lines.size()) + "\n";
+        for (std::string_view line : lines)
+        {
+            out.append(line);
+            out.push_back('\n');
+        }
+        return out;
+    }
+
+    // REPORT <nama> [arg]. Laporan buyer/seller memakai user session, laporan management tanpa login
+    // (sama seperti menu management di mode konsol).
+    static bool runReport(Session &session, const std::vector<std::string_view> &args)
+    {
+        Store &store = Store::getInstance();
+        Bank &bank = Bank::getInstance();
+        std::string name = args.size() > 1 ? upper(args[1]) : "";
+        int n = 0;
+        bool hasNumber = args.size() > 2 && parsePositive(args[2], n);
+
+        if (name == "TRANSACTIONS" && hasNumber)
+            store.listTransactionsLastKDays(n);
+        else if (name == "UNCOMPLETED")
+            store.listPaidUncompletedTransactions();
+        else if (name == "FREQUENT" && hasNumber)
+            store.listMostFrequentItems(n);
+        else if (name == "ACTIVE_BUYERS" && hasNumber)
+            store.listMostActiveBuyers(n);
+        else if (name == "ACTIVE_SELLERS" && hasNumber)
+            store.listMostActiveSellers(n);
+        else if (name == "BANK_WEEK")
+            bank.listTransactionsWithinAWeek();
+        else if (name == "CUSTOMERS")
+            bank.listAllCustomers();
+        else if (name == "DORMANT")
+            bank.listDormantAccounts();
+        else if (name == "TOP_TODAY" && hasNumber)
+            bank.listTopNUsersToday(n);
+        else if (name == "MEMORY")
+            std::cout << MemoryFootprint::toCsv(store.memoryUsage()); // CSV, sama dengan memory.csv
+        else if (name == "SPENDING" || name == "ORDERS" || name == "CASHFLOW")
+        {
+            BuyerPtr buyer = std::dynamic_pointer_cast<Buyer>(session.user);
+            if (!buyer)
+            {
+                std::cout << "Error: Login sebagai buyer/seller terlebih dahulu." << std::endl;
+                return false;
+            }
+            if (name == "ORDERS")
+            {
+                std::string status = args.size() > 2 ? upper(args[2]) : "PAID";
+                TransactionStatus filter = status == "COMPLETED"   ? TransactionStatus::COMPLETED
+                                           : status == "CANCELLED" ? TransactionStatus::CANCELLED
+                                                                   : TransactionStatus::PAID;
+                store.listOrders(buyer->getOrderIds(), filter);
+            }
+            else if (!hasNumber)
+            {
+                std::cout << "Error: " << name << " membutuhkan jumlah hari." << std::endl;
+                return false;
+            }
+            else if (name == "SPENDING")
+                store.checkSpending(buyer, n);
+            else
+                buyer->displayCashFlow(n);
+        }
+        else if (name == "POPULAR" || name == "LOYAL" || name == "LOWSTOCK")
+        {
+            SellerPtr seller = std::dynamic_pointer_cast<Seller>(session.user);
+            if (!seller)
+            {
+                std::cout << "Error: Login sebagai seller terlebih dahulu." << std::endl;
+                return false;
+            }
+            if (name == "LOYAL")
+                store.discoverLoyalCustomer(seller);
+            else if (name == "LOWSTOCK")
+                seller->displayLowStock();
+            else if (hasNumber)
+                store.discoverPopularItems(seller, n);
+            else
+            {
+                std::cout << "Error: POPULAR membutuhkan jumlah item." << std::endl;
+                return false;
+            }
+        }
+        else
+        {
+            std::cout << "Error: Laporan tidak dikenal atau argumen tidak valid." << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // Jalankan satu perintah untuk session ini. Dipanggil worker di bawah engine lock.
+    static bool runCommand(Session &session, std::vector<std::string_view> args, bool &quit)
+    {
+        Store &store = Store::getInstance();
+        std::string command = upper(args[0]);
+        std::string key = takeIdempotencyKey(args);
+        size_t argc = args.size();
+
+        if (command == "PING")
+            return true;
+        if (command == "QUIT")
+        {
+            quit = true;
+            return true;
+        }
+        if (command == "REGISTER" && argc == 4)
+        {
+            std::string role = upper(args[1]);
+            if (role != "BUYER" && role != "SELLER")
+            {
+                std::cout << "Error: Role harus BUYER atau SELLER." << std::endl;
+                return false;
+            }
+            return store.registerUser(std::string(args[2]), std::string(args[3]), role == "SELLER");
+        }
+        if (command == "LOGIN" && argc == 3)
+        {
+            session.user = store.login(std::string(args[1]), std::string(args[2]));
+            return session.user != nullptr;
+        }
+        if (command == "REPORT" && argc >= 2)
+            return runReport(session, args);
+
+        // Perintah berikut membutuhkan login
+        if (command != "LOGOUT" && command != "BALANCE" && command != "TOPUP" &&
+            command != "WITHDRAW" && command != "PURCHASE")
+        {
+            std::cout << "Error: Perintah tidak dikenal atau jumlah argumen salah." << std::endl;
+            return false;
+        }
+        if (!session.user)
+        {
+            std::cout << "Error: Belum login." << std::endl;
+            return false;
+        }
+
+        if (command == "LOGOUT" && argc == 1)
+        {
+            session.user = nullptr;
+            std::cout << "Anda telah logout." << std::endl;
+            return true;
+        }
+        if (command == "BALANCE" && argc == 1)
+        {
+            std::cout << "Saldo: " << session.user->getAccount()->getBalance() << std::endl;
+            return true;
+        }
+        if ((command == "TOPUP" || command == "WITHDRAW") && argc == 2)
+        {
+            double amount = 0.0;
+            if (!parsePositive(args[1], amount))
+            {
+                std::cout << "Error: Jumlah harus angka positif." << std::endl;
+                return false;
+            }
+            TransactionType type = command == "TOPUP" ? TransactionType::TOPUP : TransactionType::WITHDRAW;
+            if (!Bank::getInstance().processBankTransaction(session.user->getId(), amount, type, key))
+            {
+                std::cout << (command == "TOPUP" ? "Topup gagal." : "Withdraw gagal (Saldo tidak cukup/jumlah tidak valid).") << std::endl;
+                return false;
+            }
+            std::cout << "Saldo baru: " << session.user->getAccount()->getBalance() << std::endl;
+            return true;
+        }
+        if (command == "PURCHASE" && argc == 3)
+        {
+            int quantity = 0;
+            if (!parsePositive(args[2], quantity))
+            {
+                std::cout << "Error: Kuantitas harus angka positif." << std::endl;
+                return false;
+            }
+            return store.purchaseItem(session.user, std::string(args[1]), quantity, key);
+        }
+        std::cout << "Error: Jumlah argumen salah." << std::endl;
+        return false;
+    }
+
+    // Baris status replica: umur snapshot yang dimuat dan ketertinggalannya dari journal primary
+    void printReplicaStatus()
+    {
+        if (replicaTakenAt == 0)
+        {
+            std::cout << "Replica: belum ada snapshot dari primary." << std::endl;
+            return;
+        }
+        time_t now = DateUtility::getCurrentTime();
+        uint64_t primaryJournal = replica->primaryJournal();
+        std::cout << "Replica: snapshot generasi " << replica->getGeneration() << ", umur " << now - replicaTakenAt
+                  << " detik, tertinggal " << (primaryJournal > replicaJournal ? primaryJournal - replicaJournal : 0)
+                  << " perubahan dari primary";
+        time_t heartbeat = replica->primaryHeartbeat();
+        if (now - heartbeat > 2 * PUBLISH_INTERVAL_SEC)
+            std::cout << " (primary tidak aktif sejak " << now - heartbeat << " detik lalu)";
+        std::cout << "." << std::endl;
+    }
+
+    // Replica hanya melayani perintah baca dari snapshot terakhir; perintah yang mengubah data ditolak.
+    // Dipanggil worker di bawah engine lock.
+    bool runReplicaCommand(Session &session, std::vector<std::string_view> args, bool &quit)
+    {
+        std::string command = upper(args[0]);
+        if (session.user) // Objek user diganti setiap snapshot dimuat ulang, cari lagi berdasarkan ID
+        {
+            const auto &users = Store::getInstance().getUsers();
+            auto it = users.find(session.user->getId());
+            session.user = it != users.end() ? it->second : nullptr;
+        }
+        if (command == "REPORT")
+        {
+            printReplicaStatus();
+            if (args.size() == 2 && upper(args[1]) == "LAG")
+                return true;
+        }
+        else if (command != "PING" && command != "QUIT" && command != "LOGIN" && command != "LOGOUT" && command != "BALANCE")
+        {
+            std::cout << "Error: Replica hanya melayani perintah baca. Kirim perintah ini ke primary." << std::endl;
+            return false;
+        }
+        return runCommand(session, std::move(args), quit);
+    }
+
+    std::string execute(Session &session, const std::string &line, bool &quit)
+    {
+        static Metrics::Histogram &latency = Metrics::getInstance().histogram("server_request_seconds", "Latensi eksekusi perintah server");
+        std::vector<std::string_view> args = tokenize(line);
+        bool ok;
+        std::string body;
+        exclusively([&]()
+                    {
+                        Metrics::ScopedTimer timer(latency);
+                        CoutCapture capture;
+                        ok = replica ? runReplicaCommand(session, args, quit) : runCommand(session, args, quit);
+                        body = capture.str(); });
+        if (!ok && body.empty())
+            body = "Perintah gagal.";
+        return frame(ok, body);
+    }
+
+    void workerLoop()
+    {
+        for (;;)
+        {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(jobMtx);
+                jobCv.wait(lock, [this]()
+                           { return stopping || !jobs.empty(); });
+                if (jobs.empty())
+                    return; // stopping dan antrean sudah habis
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+
+            if (!job.connection)
+            {
+                maintain(job.maintenance);
+                continue;
+            }
+
+            bool quit = false;
+            std::string response = execute(job.connection->session, job.line, quit);
+            complete({std::move(job.connection), std::move(response), quit});
+        }
+    }
+
+    void maintain(Maintenance maintenance)
+    {
+        if (maintenance == Maintenance::CHECKPOINT)
+        {
+            exclusively([]()
+                        { DataPersistence::saveIncremental(); });
+        }
+        else if (maintenance == Maintenance::PUBLISH)
+        {
+            // Hanya penyalinan record yang berubah yang berjalan exclusive; penggabungan ke image, serialisasi,
+            // dan penulisan ke shared memory di background. Jika penerbitan sebelumnya belum selesai, putaran
+            // ini dilewati (perubahannya tetap tercatat untuk putaran berikutnya).
+            exclusively([this]()
+                        {
+                            if (pendingPublish.valid() && pendingPublish.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                                return;
+                            std::shared_ptr<ReplicaImage> delta = DataPersistence::captureReplicaChanges();
+                            publishedJournal.store(delta->journalPosition, std::memory_order_relaxed);
+                            pendingPublish = std::async(std::launch::async, [this, delta]()
+                                                        {
+                                                            DataPersistence::applyReplicaChanges(replicaImage, std::move(*delta));
+                                                            bool ok = DataPersistence::publishReplica(*publisher, replicaImage);
+                                                            if (!ok)
+                                                            {
+                                                                std::cerr << "Error: Gagal menerbitkan snapshot replica." << std::endl;
+                                                                publishedJournal.store(UINT64_MAX, std::memory_order_relaxed); // Coba lagi putaran berikutnya
+                                                            }
+                                                            return ok; }); });
+        }
+        else
+        {
+            exclusively([this]()
+                        {
+                            if (replica->hasNewGeneration() && replica->attachLatest())
+                            {
+                                DataPersistence::loadReplica(*replica);
+                                replicaJournal = replica->header().journalPosition;
+                                replicaTakenAt = static_cast<time_t>(replica->header().takenAt);
+                                replica->release();
+                            } });
+            refreshQueued.store(false, std::memory_order_release);
+        }
+    }
+
+    // Serahkan respons ke event loop (dipanggil worker atau thread shard)
+    void complete(Completion &&done)
+    {
+        {
+            std::lock_guard<std::mutex> lock(completionMtx);
+            completions.push_back(std::move(done));
+        }
+        uint64_t one = 1;
+        ssize_t ignored = ::write(wakeFd, &one, sizeof(one)); // Bangunkan event loop
+        (void)ignored;
+    }
+
+    // Mode shard: perintah akun milik user yang sudah login langsung dikirim ke shard user tersebut.
+    // Mengembalikan false jika perintah harus lewat worker (termasuk argumen tidak valid, yang pesan
+    // error-nya dibuat runCommand). Session aman dibaca di sini karena koneksi tidak sedang busy.
+    bool routeToShard(const ConnectionPtr &connection, const std::string &line)
+    {
+        static Metrics::Histogram &latency = Metrics::getInstance().histogram("server_shard_request_seconds", "Latensi perintah server yang dijalankan di shard");
+        UserPtr user = connection->session.user;
+        if (!shards || !user)
+            return false;
+        std::vector<std::string_view> args = tokenize(line);
+        if (args.empty())
+            return false;
+        std::string command = upper(args[0]);
+        std::string key = takeIdempotencyKey(args);
+
+        auto started = std::chrono::steady_clock::now();
+        ShardEngine::Reply reply = [this, connection, started](bool ok, std::string body)
+        {
+            auto elapsed = std::chrono::steady_clock::now() - started;
+            latency.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+            complete({connection, frame(ok, body), false});
+        };
+
+        if (command == "BALANCE" && args.size() == 1)
+        {
+            shards->balance(user, reply);
+            return true;
+        }
+        double amount = 0.0;
+        if ((command == "TOPUP" || command == "WITHDRAW") && args.size() == 2 && parsePositive(args[1], amount))
+        {
+            shards->bankTransaction(user, amount, command == "TOPUP" ? TransactionType::TOPUP : TransactionType::WITHDRAW, key, reply);
+            return true;
+        }
+        int quantity = 0;
+        if (command == "PURCHASE" && args.size() == 3 && parsePositive(args[2], quantity))
+        {
+            shards->purchase(user, std::string(args[1]), quantity, key, reply);
+            return true;
+        }
+        return false;
+    }
+
+    void submit(Job &&job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(jobMtx);
+            jobs.push_back(std::move(job));
+        }
+        jobCv.notify_one();
+    }
+
+    // --- Event loop (satu thread) ---
+
+    bool watch(int fd, uint32_t events, int op)
+    {
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.fd = fd;
+        return ::epoll_ctl(epollFd, op, fd, &ev) == 0;
+    }
+
+    bool openListener(const std::string &address)
+    {
+        if (address.rfind("unix:", 0) == 0)
+        {
+            unixPath = address.substr(5);
+            sockaddr_un addr{};
+            addr.sun_family = AF_UNIX;
+            if (unixPath.empty() || unixPath.size() >= sizeof(addr.sun_path))
+                return false;
+            std::memcpy(addr.sun_path, unixPath.c_str(), unixPath.size() + 1);
+            ::unlink(unixPath.c_str()); // Sisa socket dari proses sebelumnya
+            listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            if (listenFd < 0 || ::bind(listenFd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0)
+                return false;
+        }
+        else
+        {
+            int port = 0;
+            if (!parsePositive(std::string_view(address), port) || port > 65535)
+                return false;
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(static_cast<uint16_t>(port));
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // Hanya localhost
+            listenFd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            int reuse = 1;
+            if (listenFd < 0 || ::setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0 ||
+                ::bind(listenFd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0)
+                return false;
+        }
+        return ::listen(listenFd, SOMAXCONN) == 0 && watch(listenFd, EPOLLIN, EPOLL_CTL_ADD);
+    }
+
+    void acceptAll()
+    {
+        static Metrics::Counter &accepted = Metrics::getInstance().counter("server_connections_total", "Jumlah koneksi client diterima");
+        for (;;)
+        {
+            int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0)
+            {
+                if (errno == EINTR || errno == ECONNABORTED)
+                    continue;
+                return; // EAGAIN: tidak ada lagi; EMFILE dll: coba lagi di putaran berikutnya
+            }
+            if (!watch(fd, EPOLLIN | EPOLLRDHUP, EPOLL_CTL_ADD))
+            {
+                ::close(fd);
+                continue;
+            }
+            connections[fd] = std::make_shared<Connection>(fd);
+            accepted.increment();
+        }
+    }
+
+    void closeConnection(const ConnectionPtr &connection)
+    {
+        if (connection->closed)
+            return;
+        connection->closed = true; // Respons worker yang masih berjalan akan dibuang
+        ::epoll_ctl(epollFd, EPOLL_CTL_DEL, connection->fd, nullptr);
+        ::close(connection->fd);
+        connections.erase(connection->fd);
+    }
+
+    // Serahkan perintah berikutnya ke worker jika koneksi tidak sedang menunggu perintah lain
+    void dispatchNext(const ConnectionPtr &connection)
+    {
+        if (connection->busy || connection->closing || connection->pending.empty())
+            return;
+        connection->busy = true;
+        std::string line = std::move(connection->pending.front());
+        connection->pending.pop_front();
+        if (!routeToShard(connection, line))
+            submit({connection, std::move(line)});
+    }
+
+    void flush(const ConnectionPtr &connection)
+    {
+        while (!connection->output.empty())
+        {
+            ssize_t sent = ::send(connection->fd, connection->output.data(), connection->output.size(), MSG_NOSIGNAL);
+            if (sent < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                {
+                    // Socket penuh: tunggu EPOLLOUT
+                    if (!connection->writeArmed)
+                        connection->writeArmed = watch(connection->fd, EPOLLIN | EPOLLRDHUP | EPOLLOUT, EPOLL_CTL_MOD);
+                    return;
+                }
+                closeConnection(connection);
+                return;
+            }
+            connection->output.erase(0, static_cast<size_t>(sent));
+        }
+        if (connection->writeArmed)
+            connection->writeArmed = !watch(connection->fd, EPOLLIN | EPOLLRDHUP, EPOLL_CTL_MOD);
+        if (connection->closing && !connection->busy)
+            closeConnection(connection);
+    }
+
+    void readAll(const ConnectionPtr &connection)
+    {
+        char buffer[16384];
+        for (;;)
+        {
+            ssize_t received = ::recv(connection->fd, buffer, sizeof(buffer), 0);
+            if (received > 0)
+            {
+                connection->input.append(buffer, static_cast<size_t>(received));
+                continue;
+            }
+            if (received < 0 && errno == EINTR)
+                continue;
+            if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                break;
+            closeConnection(connection); // EOF atau error
+            return;
+        }
+
+        size_t start = 0, newline;
+        while ((newline = connection->input.find('\n', start)) != std::string::npos)
+        {
+            size_t end = newline > start && connection->input[newline - 1] == '\r' ? newline - 1 : newline;
+            if (end > start)
+                connection->pending.emplace_back(connection->input, start, end - start);
+            start = newline + 1;
+        }
+        connection->input.erase(0, start);
+
+        if (connection->input.size() > MAX_LINE || connection->pending.size() > MAX_PENDING)
+        {
+            connection->pending.clear();
+            connection->output += frame(false, "Error: Baris terlalu panjang atau terlalu banyak perintah antre.");
+            connection->closing = true;
+            flush(connection);
+            return;
+        }
+        dispatchNext(connection);
+    }
+
+    void drainCompletions()
+    {
+        uint64_t count;
+        ssize_t ignored = ::read(wakeFd, &count, sizeof(count));
+        (void)ignored;
+
+        std::vector<Completion> ready;
+        {
+            std::lock_guard<std::mutex> lock(completionMtx);
+            ready.swap(completions);
+        }
+        for (Completion &done : ready)
+        {
+            ConnectionPtr &connection = done.connection;
+            connection->busy = false;
+            if (connection->closed)
+                continue;
+            connection->output += done.response;
+            if (done.quit)
+            {
+                connection->pending.clear();
+                connection->closing = true;
+            }
+            dispatchNext(connection);
+            flush(connection);
+        }
+    }
+
+    bool start(const std::string &address)
+    {
+        // Naikkan batas file descriptor agar ribuan koneksi bisa dibuka
+        rlimit limit{};
+        if (::getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max)
+        {
+            limit.rlim_cur = limit.rlim_max;
+            ::setrlimit(RLIMIT_NOFILE, &limit);
+        }
+
+        // SIGINT/SIGTERM diterima lewat signalfd; mask diblokir sebelum worker dibuat agar diwarisi
+        sigset_t mask;
+        sigemptyset(&mask);
+        sigaddset(&mask, SIGINT);
+        sigaddset(&mask, SIGTERM);
+        ::pthread_sigmask(SIG_BLOCK, &mask, nullptr);
+
+        epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+        wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        signalFd = ::signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+        if (epollFd < 0 || wakeFd < 0 || signalFd < 0 ||
+            !watch(wakeFd, EPOLLIN, EPOLL_CTL_ADD) || !watch(signalFd, EPOLLIN, EPOLL_CTL_ADD) ||
+            !openListener(address))
+            return false;
+
+        for (size_t i = 0; i < Parallel::workerCount(); ++i)
+            workers.emplace_back([this]()
+                                 { workerLoop(); });
+        if (shardCount > 0)
+            shards = std::make_unique<ShardEngine>(shardCount);
+        return true;
+    }
+
+    void loop()
+    {
+        std::vector<epoll_event> events(256);
+        auto lastCheckpoint = std::chrono::steady_clock::now();
+        auto lastPublish = std::chrono::steady_clock::time_point(); // Terbitkan segera setelah start
+        bool running = true;
+        while (running)
+        {
+            int n = ::epoll_wait(epollFd, events.data(), static_cast<int>(events.size()), 1000);
+            for (int i = 0; i < n; ++i)
+            {
+                int fd = events[i].data.fd;
+                if (fd == listenFd)
+                    acceptAll();
+                else if (fd == wakeFd)
+                    drainCompletions();
+                else if (fd == signalFd)
+                    running = false;
+                else
+                {
+                    auto it = connections.find(fd);
+                    if (it == connections.end())
+                        continue;
+                    ConnectionPtr connection = it->second;
+                    if (events[i].events & EPOLLOUT)
+                        flush(connection);
+                    if (!connection->closed && (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)))
+                        readAll(connection);
+                }
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            if (!replica && now - lastCheckpoint >= std::chrono::seconds(CHECKPOINT_INTERVAL_SEC))
+            {
+                submit({nullptr, std::string(), Maintenance::CHECKPOINT});
+                lastCheckpoint = now;
+            }
+            if (publisher)
+            {
+                publisher->heartbeat(Journal::getInstance().getPosition(), DateUtility::getCurrentTime());
+                // Putaran dilewati jika journal tidak bergerak sejak penerbitan terakhir
+                if (now - lastPublish >= std::chrono::seconds(PUBLISH_INTERVAL_SEC) &&
+                    Journal::getInstance().getPosition() != publishedJournal.load(std::memory_order_relaxed))
+                {
+                    submit({nullptr, std::string(), Maintenance::PUBLISH});
+                    lastPublish = now;
+                }
+            }
+            // Replica memeriksa generasi baru setiap putaran (paling lama 1 detik)
+            if (replica && !refreshQueued.exchange(true, std::memory_order_acq_rel))
+                submit({nullptr, std::string(), Maintenance::REFRESH});
+        }
+    }
+
+    void shutdown()
+    {
+        {
+            std::lock_guard<std::mutex> lock(jobMtx);
+            stopping = true;
+        }
+        jobCv.notify_all();
+        for (auto &worker : workers)
+            worker.join();
+        shards.reset(); // Selesaikan pesan shard yang masih antre sebelum data disimpan
+        if (pendingPublish.valid())
+            pendingPublish.wait(); // Publisher masih dipakai thread penerbitan
+
+        std::vector<ConnectionPtr> open;
+        for (auto &pair : connections)
+            open.push_back(pair.second);
+        for (auto &connection : open)
+            closeConnection(connection);
+
+        for (int fd : {listenFd, wakeFd, signalFd, epollFd})
+        {
+            if (fd >= 0)
+                ::close(fd);
+        }
+        if (!unixPath.empty())
+            ::unlink(unixPath.c_str());
+    }
+
+public:
+    // Jalankan server sampai menerima SIGINT/SIGTERM, lalu simpan snapshot penuh.
+    // address: nomor port TCP (127.0.0.1) atau "unix:<path>". shardCount = 0 menonaktifkan shard.
+    // publishName: nama shm untuk menerbitkan snapshot replica (kosong = tidak menerbitkan).
+    // replicaName: jalankan sebagai replica read-only dari nama shm ini (tanpa shard, tidak menyimpan data).
+    // Mengembalikan exit code proses.
+    static int run(const std::string &address, size_t shardCount = 0,
+                   const std::string &publishName = "", const std::string &replicaName = "")
+    {
+        for (const std::string &name : {publishName, replicaName})
+        {
+            if (!name.empty() && !SharedSnapshot::validName(name))
+            {
+                std::cerr << "Error: Nama snapshot replica tidak valid: " << name << std::endl;
+                return 1;
+            }
+        }
+        Server server;
+        if (!replicaName.empty())
+            server.replica = std::make_unique<SharedSnapshot::Reader>(replicaName);
+        else
+            server.shardCount = shardCount;
+        if (!publishName.empty() && !server.replica)
+        {
+            server.publisher = std::make_unique<SharedSnapshot::Publisher>(publishName);
+            if (!server.publisher->isOpen())
+            {
+                std::cerr << "Error: Gagal membuka shared memory " << publishName << " (" << std::strerror(errno) << ")." << std::endl;
+                return 1;
+            }
+            ChangeTracker::getInstance().enableReplicaFeed();
+        }
+        if (!server.start(address))
+        {
+            std::cerr << "Error: Gagal membuka server di " << address << " (" << std::strerror(errno) << ")." << std::endl;
+            server.shutdown();
+            return 1;
+        }
+        std::cerr << "Server berjalan di " << address << " dengan " << server.workers.size() << " worker";
+        if (server.shards)
+            std::cerr << " dan " << server.shards->size() << " shard";
+        if (server.publisher)
+            std::cerr << ", menerbitkan snapshot replica ke " << publishName;
+        if (server.replica)
+            std::cerr << " sebagai replica read-only dari " << replicaName;
+        std::cerr << "." << std::endl;
+        server.loop();
+        if (server.replica)
+        {
+            std::cerr << "Replica berhenti." << std::endl;
+            server.shutdown();
+            return 0;
+        }
+        std::cerr << "Server berhenti, menyimpan data..." << std::endl;
+        server.shutdown();
+        DataPersistence::saveData();
+        return 0;
+    }
+};
+
+#endif // SERVER_H
@@ -0,0 +1,399 @@
+// File: ShardEngine.h
+
+#ifndef SHARDENGINE_H
+#define SHARDENGINE_H
+
+#include <sstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <functional>
+#include "Store.h"
+#include "Metrics.h"
+
+// Eksekusi ala actor untuk mode server: user dipartisi ke N shard berdasarkan hash UserId. Setiap shard
+// punya satu thread dan mailbox; akun bank, katalog, dan daftar order seorang user hanya diubah oleh
+// thread shard miliknya, sehingga operasi user di shard berbeda berjalan paralel tanpa lock per akun.
+// Pembelian lintas shard berjalan dua fase lewat pesan:
+//   1. shard buyer : reservasi stok (CAS), cek saldo, debit buyer per leg (Bank::prepareTransfer)
+//   2. shard seller: kredit seller (Bank::commitTransfer), stok di-commit, transaksi dicatat (Store::commitLeg)
+//   3. shard buyer : ID order ditambahkan ke buyer; respons dikirim setelah semua leg selesai
+// Perintah yang membaca/mengubah state lintas user (register, login, laporan, checkpoint) memakai
+// exclusive(): pembelian yang sedang berjalan dituntaskan dulu, lalu semua shard dijeda di batas pesan
+// dan perintah berjalan sendirian.
+// Task shard tidak boleh menulis ke std::cout (dialihkan per perintah oleh Server).
+class ShardEngine
+{
+public:
+    using Reply = std::function<void(bool ok, std::string body)>;
+
+private:
+    struct Shard
+    {
+        std::mutex mtx;
+        std::condition_variable cv;
+        std::deque<std::function<void()>> mailbox;
+        bool stopping = false;
+        std::thread thread;
+    };
+
+    // Status satu pembelian selama leg-legnya berpindah antar shard. Hanya diubah di shard buyer,
+    // kecuali leg[i] yang dibaca shard seller saat commit.
+    struct PendingPurchase
+    {
+        UserPtr buyer;
+        Id itemId;
+        std::vector<Store::PurchaseLeg> legs;
+        size_t remaining = 0;
+        std::string failure; // Tidak kosong = pembelian terhenti di tengah (leg yang sudah dibayar tetap dicatat)
+        Reply reply;
+    };
+    using PendingPtr = std::shared_ptr<PendingPurchase>;
+
+    struct Barrier
+    {
+        std::mutex mtx;
+        std::condition_variable cv;
+        size_t paused = 0;
+        bool released = false;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::mutex exclusiveMtx; // Satu perintah exclusive dalam satu waktu
+
+    // Pembelian yang sedang berjalan (sudah diterima, belum dibalas). Selama exclusive() menunggu dan
+    // berjalan, pembelian baru ditahan di deferred lalu dikirim ke shard-nya setelah selesai.
+    std::mutex flightMtx;
+    std::condition_variable flightCv;
+    size_t inFlight = 0;
+    bool admitting = true;
+    std::vector<std::pair<size_t, std::function<void()>>> deferred; // (shard buyer, langkah 1)
+
+    void admitPurchase(size_t home, std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(flightMtx);
+            if (!admitting)
+            {
+                deferred.emplace_back(home, std::move(task));
+                return;
+            }
+            inFlight++;
+        }
+        post(home, std::move(task));
+    }
+
+    void purchaseDone()
+    {
+        std::lock_guard<std::mutex> lock(flightMtx);
+        if (--inFlight == 0)
+            flightCv.notify_all();
+    }
+
+    void reopenPurchases()
+    {
+        std::vector<std::pair<size_t, std::function<void()>>> waiting;
+        {
+            std::lock_guard<std::mutex> lock(flightMtx);
+            admitting = true;
+            waiting.swap(deferred);
+            inFlight += waiting.size();
+        }
+        for (auto &entry : waiting)
+            post(entry.first, std::move(entry.second));
+    }
+
+    void runShard(Shard &shard)
+    {
+        for (;;)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(shard.mtx);
+                shard.cv.wait(lock, [&shard]()
+                              { return shard.stopping || !shard.mailbox.empty(); });
+                if (shard.mailbox.empty())
+                    return; // stopping dan mailbox sudah habis
+                task = std::move(shard.mailbox.front());
+                shard.mailbox.pop_front();
+            }
+            task();
+        }
+    }
+
+    // Langkah 3: dijalankan di shard buyer setelah satu leg diproses di shard seller
+    // (recorded = false jika Store::commitLeg menolak ID transaksinya)
+    void finishLeg(const PendingPtr &order, size_t index, bool recorded)
+    {
+        static Metrics::Counter &purchaseOk = Metrics::getInstance().counter("store_purchase_total", "Jumlah pembelian per hasil", "result=\"ok\"");
+
+        auto buyerPtr = std::dynamic_pointer_cast<Buyer>(order->buyer);
+        if (!recorded)
+            order->failure = "Pembelian terhenti: ID transaksi " + order->legs[index].transactionId + " bentrok. Terbayar: ";
+        else if (buyerPtr)
+            buyerPtr->addOrderId(order->legs[index].transactionId);
+        if (--order->remaining > 0)
+            return;
+
+        std::ostringstream body;
+        double paid = 0.0;
+        for (const Store::PurchaseLeg &leg : order->legs)
+        {
+            paid += leg.amount;
+            body << "  " << leg.transactionId << ": " << leg.quantity << " x " << leg.item->getPrice()
+                 << " dari seller " << leg.seller->getId() << "\n";
+        }
+        if (!order->failure.empty())
+        {
+            body << order->failure << paid;
+            order->reply(false, body.str());
+            return;
+        }
+        body << "Pembelian item '" << order->legs.front().item->getName() << "' berhasil. Total: " << paid;
+        purchaseOk.increment();
+        order->reply(true, body.str());
+    }
+
+    // Langkah 2: dijalankan di shard seller
+    void commitLeg(const PendingPtr &order, size_t index, size_t home)
+    {
+        Store::PurchaseLeg &leg = order->legs[index];
+        Bank::getInstance().commitTransfer(leg.seller->getId(), leg.payment);
+        bool recorded = Store::getInstance().commitLeg(order->buyer->getId(), order->itemId, leg);
+        if (shardOf(leg.seller->getId()) == home)
+            finishLeg(order, index, recorded);
+        else
+            post(home, [this, order, index, recorded]()
+                 { finishLeg(order, index, recorded); });
+    }
+
+public:
+    explicit ShardEngine(size_t count)
+    {
+        for (size_t i = 0; i < std::max<size_t>(count, 1); ++i)
+            shards.push_back(std::make_unique<Shard>());
+        for (auto &shard : shards)
+        {
+            Shard *s = shard.get();
+            s->thread = std::thread([this, s]()
+                                    { runShard(*s); });
+        }
+    }
+
+    ~ShardEngine()
+    {
+        for (auto &shard : shards)
+        {
+            {
+                std::lock_guard<std::mutex> lock(shard->mtx);
+                shard->stopping = true;
+            }
+            shard->cv.notify_one();
+        }
+        for (auto &shard : shards)
+            shard->thread.join();
+    }
+
+    ShardEngine(const ShardEngine &) = delete;
+    ShardEngine &operator=(const ShardEngine &) = delete;
+
+    size_t size() const { return shards.size(); }
+
+    size_t shardOf(const Id &userId) const
+    {
+        return userId.hash() % shards.size();
+    }
+
+    void post(size_t shard, std::function<void()> task)
+    {
+        Shard &target = *shards[shard];
+        {
+            std::lock_guard<std::mutex> lock(target.mtx);
+            target.mailbox.push_back(std::move(task));
+        }
+        target.cv.notify_one();
+    }
+
+    // Jalankan fn saat semua shard sedang berhenti di antara dua pesan. Tidak boleh dipanggil dari thread shard.
+    // Pembelian yang sudah mendebit buyer tetapi belum mengkredit seller dan mencatat transaksinya ditunggu
+    // sampai selesai lebih dulu, sehingga fn (mis. checkpoint) tidak pernah melihat dana "dalam perjalanan".
+    template <typename Fn>
+    void exclusive(Fn fn)
+    {
+        std::lock_guard<std::mutex> serial(exclusiveMtx);
+        {
+            std::unique_lock<std::mutex> lock(flightMtx);
+            admitting = false;
+            flightCv.wait(lock, [this]()
+                          { return inFlight == 0; });
+        }
+        auto barrier = std::make_shared<Barrier>();
+        for (size_t i = 0; i < shards.size(); ++i)
+        {
+            post(i, [barrier]()
+                 {
+                     std::unique_lock<std::mutex> lock(barrier->mtx);
+                     barrier->paused++;
+                     barrier->cv.notify_all();
+                     barrier->cv.wait(lock, [&barrier]() { return barrier->released; }); });
+        }
+
+        auto release = [&barrier]()
+        {
+            {
+                std::lock_guard<std::mutex> lock(barrier->mtx);
+                barrier->released = true;
+            }
+            barrier->cv.notify_all();
+        };
+        {
+            std::unique_lock<std::mutex> lock(barrier->mtx);
+            barrier->cv.wait(lock, [this, &barrier]()
+                             { return barrier->paused == shards.size(); });
+        }
+        try
+        {
+            fn();
+        }
+        catch (...)
+        {
+            release();
+            reopenPurchases();
+            throw;
+        }
+        release();
+        reopenPurchases();
+    }
+
+    // --- Operasi per user (reply dipanggil dari thread shard) ---
+
+    void balance(const UserPtr &user, Reply reply)
+    {
+        post(shardOf(user->getId()), [user, reply]()
+             {
+                 std::ostringstream body;
+                 body << "Saldo: " << user->getAccount()->getBalance();
+                 reply(true, body.str()); });
+    }
+
+    void bankTransaction(const UserPtr &user, double amount, TransactionType type, const std::string &idempotencyKey, Reply reply)
+    {
+        post(shardOf(user->getId()), [user, amount, type, idempotencyKey, reply]()
+             {
+                 std::ostringstream body;
+                 if (!Bank::getInstance().processBankTransaction(user->getId(), amount, type, idempotencyKey))
+                 {
+                     body << (type == TransactionType::TOPUP ? "Topup gagal." : "Withdraw gagal (Saldo tidak cukup/jumlah tidak valid).");
+                     reply(false, body.str());
+                     return;
+                 }
+                 body << "Saldo baru: " << user->getAccount()->getBalance();
+                 reply(true, body.str()); });
+    }
+
+    // Langkah 1: dijalankan di shard buyer. idempotencyKey kosong = tanpa dedupe.
+    void purchase(const UserPtr &buyer, const Id &itemId, int quantity, const std::string &idempotencyKey, Reply reply)
+    {
+        size_t home = shardOf(buyer->getId());
+        Reply original = std::move(reply);
+        reply = [this, original](bool ok, std::string body)
+        {
+            original(ok, std::move(body));
+            purchaseDone(); // Setiap pembelian dibalas tepat sekali
+        };
+        admitPurchase(home, [this, buyer, itemId, quantity, idempotencyKey, reply, home]() mutable
+             {
+                 static Metrics::Counter &insufficientBalance = Metrics::getInstance().counter("store_purchase_total", "Jumlah pembelian per hasil", "result=\"insufficient_balance\"");
+                 Store &store = Store::getInstance();
+                 Bank &bank = Bank::getInstance();
+
+                 if (!idempotencyKey.empty())
+                 {
+                     std::string key = Idempotency::scopedKey(buyer->getId(), idempotencyKey);
+                     std::string request = Idempotency::requestOf("PURCHASE", std::string(itemId) + " " + std::to_string(quantity));
+                     Idempotency::Result previous;
+                     switch (Idempotency::getInstance().begin(key, request, previous))
+                     {
+                     case Idempotency::Status::REPLAY:
+                         reply(previous.ok, previous.body);
+                         return;
+                     case Idempotency::Status::IN_PROGRESS:
+                         reply(false, "Pembelian dengan kunci ini masih diproses.");
+                         return;
+                     case Idempotency::Status::CONFLICT:
+                         reply(false, "Idempotency key sudah dipakai untuk permintaan lain.");
+                         return;
+                     case Idempotency::Status::NEW:
+                         break;
+                     }
+                     // Hasil disimpan tepat sebelum respons dikirim (bisa dari shard lain)
+                     reply = [key, reply](bool ok, std::string body)
+                     {
+                         Idempotency::getInstance().finish(key, {ok, body});
+                         reply(ok, std::move(body));
+                     };
+                 }
+
+                 auto order = std::make_shared<PendingPurchase>();
+                 order->buyer = buyer;
+                 order->itemId = itemId;
+                 order->reply = reply;
+                 std::string error;
+                 if (!store.reserveLegs(itemId, quantity, order->legs, error))
+                 {
+                     reply(false, error);
+                     return;
+                 }
+
+                 // Saldo buyer hanya berubah di shard ini, jadi cek ini tetap berlaku selama debit di bawah
+                 double total = 0.0;
+                 for (const Store::PurchaseLeg &leg : order->legs)
+                     total += leg.amount;
+                 BankAccountPtr account = bank.getAccount(buyer->getId());
+                 if (!account || account->getBalance() < total)
+                 {
+                     Store::releaseLegs(order->legs);
+                     insufficientBalance.increment();
+                     reply(false, "Pembelian gagal: Saldo tidak cukup di akun buyer.");
+                     return;
+                 }
+
+                 for (size_t i = 0; i < order->legs.size(); ++i)
+                 {
+                     Store::PurchaseLeg &leg = order->legs[i];
+                     leg.transactionId = store.allocateTransactionId();
+                     if (!bank.prepareTransfer(buyer->getId(), leg.seller->getId(), leg.amount, leg.transactionId, leg.payment))
+                     {
+                         // Sama seperti purchaseItem: leg yang sudah dibayar tetap dicatat, sisanya dilepas
+                         Store::releaseLegs(std::vector<Store::PurchaseLeg>(order->legs.begin() + i, order->legs.end()));
+                         order->legs.resize(i);
+                         order->failure = "Pembelian terhenti: Saldo tidak cukup. Terbayar: ";
+                         insufficientBalance.increment();
+                         break;
+                     }
+                 }
+                 if (order->legs.empty())
+                 {
+                     reply(false, order->failure + "0");
+                     return;
+                 }
+
+                 order->remaining = order->legs.size();
+                 for (size_t i = 0; i < order->legs.size(); ++i)
+                 {
+                     size_t target = shardOf(order->legs[i].seller->getId());
+                     if (target == home)
+                         commitLeg(order, i, home);
+                     else
+                         post(target, [this, order, i, home]()
+                              { commitLeg(order, i, home); });
+                 } });
+    }
+};
+
+#endif // SHARDENGINE_H
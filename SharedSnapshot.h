@@ -0,0 +1,307 @@
+// File: SharedSnapshot.h
+
+#ifndef SHAREDSNAPSHOT_H
+#define SHAREDSNAPSHOT_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Snapshot untuk read replica di shared memory POSIX (/dev/shm).
+//
+// Primary menerbitkan setiap snapshot sebagai segmen baru "/<nama>.<generasi>" yang tidak pernah diubah
+// setelah terbit: Header (posisi journal, waktu, ukuran tiap bagian) lalu isi bagian-bagiannya berurutan.
+// Generasi terbaru diumumkan lewat segmen kontrol kecil "/<nama>" (atomik, lock-free). Segmen generasi
+// lama di-unlink setelah generasi berikutnya terbit; replica yang masih memetakannya tetap bisa membaca.
+// Replica memetakan semuanya PROT_READ sehingga tidak pernah menulis ke memori primary.
+class SharedSnapshot
+{
+public:
+    enum Section
+    {
+        USERS,                 // Format users.dat
+        ACCOUNTS,              // Format accounts.dat
+        TRANSACTIONS,          // Ledger biner LDG1 (transaksi toko)
+        ROLLUPS,               // Format rollups.dat
+        CASH_FLOWS,            // Ledger biner LDG1, BuyerID = pemilik akun
+        CASH_FLOW_CHECKPOINTS, // OwnerId|month|opening|count|topup|withdraw|debit|credit|lastDate
+        SECTION_COUNT
+    };
+
+    struct Header
+    {
+        char magic[4]; // "SNP1"
+        uint32_t sectionCount;
+        uint64_t journalPosition;
+        int64_t takenAt;
+        uint64_t sectionSizes[SECTION_COUNT];
+    };
+
+private:
+    struct Control
+    {
+        char magic[4];                        // "SNC1"
+        std::atomic<uint64_t> generation;     // 0 = belum ada snapshot
+        std::atomic<uint64_t> primaryJournal; // Posisi journal primary terkini, diperbarui berkala
+        std::atomic<int64_t> heartbeat;       // Waktu pembaruan primaryJournal terakhir
+    };
+    static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<int64_t>::is_always_lock_free,
+                  "Atomik di shared memory harus lock-free");
+
+    static std::string controlName(const std::string &name) { return "/" + name; }
+    static std::string segmentName(const std::string &name, uint64_t generation)
+    {
+        return "/" + name + "." + std::to_string(generation);
+    }
+
+public:
+    // Nama shm: tanpa '/', maksimal NAME_MAX dikurangi akhiran generasi
+    static bool validName(const std::string &name)
+    {
+        return !name.empty() && name.size() <= 200 && name.find('/') == std::string::npos;
+    }
+
+    // Sisi primary. Hanya satu publisher per nama.
+    class Publisher
+    {
+    private:
+        std::string name;
+        Control *control = nullptr;
+        uint64_t generation = 0; // Generasi terakhir yang diterbitkan proses ini
+
+    public:
+        explicit Publisher(const std::string &n) : name(n)
+        {
+            int fd = ::shm_open(controlName(name).c_str(), O_CREAT | O_RDWR, 0600);
+            if (fd < 0)
+                return;
+            if (::ftruncate(fd, sizeof(Control)) == 0)
+            {
+                void *p = ::mmap(nullptr, sizeof(Control), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                if (p != MAP_FAILED)
+                    control = static_cast<Control *>(p);
+            }
+            ::close(fd);
+            if (!control)
+                return;
+            // Segmen kontrol dipakai ulang antar restart primary (replica yang sudah terpasang tetap memetakannya),
+            // jadi penomoran generasi dilanjutkan agar tidak bentrok dengan generasi yang sudah dimuat replica
+            if (std::memcmp(control->magic, "SNC1", 4) == 0)
+                generation = control->generation.load(std::memory_order_acquire);
+            else
+            {
+                control->generation.store(0, std::memory_order_relaxed);
+                control->primaryJournal.store(0, std::memory_order_relaxed);
+                control->heartbeat.store(0, std::memory_order_relaxed);
+                std::memcpy(control->magic, "SNC1", 4);
+            }
+        }
+
+        // Segmen generasi terakhir dilepas. Segmen kontrol (kecil) dibiarkan beserta nomor generasinya:
+        // replica yang terpasang tetap melayani data terakhirnya, dan primary berikutnya melanjutkan penomoran.
+        ~Publisher()
+        {
+            if (!control)
+                return;
+            if (generation != 0)
+                ::shm_unlink(segmentName(name, generation).c_str());
+            ::munmap(control, sizeof(Control));
+        }
+
+        Publisher(const Publisher &) = delete;
+        Publisher &operator=(const Publisher &) = delete;
+
+        bool isOpen() const { return control != nullptr; }
+
+        // Tulis bagian-bagian snapshot ke segmen generasi baru, lalu umumkan. Dipanggil satu thread dalam satu waktu.
+        bool publish(const std::vector<std::string> &sections, uint64_t journalPosition, time_t takenAt)
+        {
+            if (!control || sections.size() != SECTION_COUNT)
+                return false;
+            Header header{};
+            std::memcpy(header.magic, "SNP1", 4);
+            header.sectionCount = SECTION_COUNT;
+            header.journalPosition = journalPosition;
+            header.takenAt = static_cast<int64_t>(takenAt);
+            size_t total = sizeof(Header);
+            for (size_t i = 0; i < SECTION_COUNT; ++i)
+            {
+                header.sectionSizes[i] = sections[i].size();
+                total += sections[i].size();
+            }
+
+            uint64_t next = generation + 1;
+            std::string path = segmentName(name, next);
+            ::shm_unlink(path.c_str()); // Sisa proses sebelumnya yang berhenti tidak normal
+            int fd = ::shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+            if (fd < 0)
+                return false;
+            void *p = ::ftruncate(fd, static_cast<off_t>(total)) == 0
+                          ? ::mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+                          : MAP_FAILED;
+            ::close(fd);
+            if (p == MAP_FAILED)
+            {
+                ::shm_unlink(path.c_str());
+                return false;
+            }
+            char *out = static_cast<char *>(p);
+            std::memcpy(out, &header, sizeof(Header));
+            out += sizeof(Header);
+            for (const std::string &section : sections)
+            {
+                std::memcpy(out, section.data(), section.size());
+                out += section.size();
+            }
+            ::munmap(p, total);
+
+            control->generation.store(next, std::memory_order_release);
+            if (generation != 0)
+                ::shm_unlink(segmentName(name, generation).c_str());
+            generation = next;
+            return true;
+        }
+
+        // Posisi journal primary saat ini, untuk menghitung ketertinggalan replica (murah, tanpa lock)
+        void heartbeat(uint64_t journalPosition, time_t now)
+        {
+            if (!control)
+                return;
+            control->primaryJournal.store(journalPosition, std::memory_order_relaxed);
+            control->heartbeat.store(static_cast<int64_t>(now), std::memory_order_release);
+        }
+    };
+
+    // Sisi replica: memetakan generasi terbaru secara read-only
+    class Reader
+    {
+    private:
+        std::string name;
+        const Control *control = nullptr;
+        const char *data = nullptr;
+        size_t length = 0;
+        uint64_t generation = 0; // Generasi yang sedang dipetakan / terakhir dimuat
+
+        // Primary bisa belum berjalan saat replica dimulai, jadi dicoba ulang setiap kali dibutuhkan
+        bool attachControl()
+        {
+            if (control)
+                return true;
+            int fd = ::shm_open(controlName(name).c_str(), O_RDONLY, 0);
+            if (fd < 0)
+                return false;
+            struct stat st;
+            if (::fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(Control))
+            {
+                void *p = ::mmap(nullptr, sizeof(Control), PROT_READ, MAP_SHARED, fd, 0);
+                if (p != MAP_FAILED)
+                    control = static_cast<const Control *>(p);
+            }
+            ::close(fd);
+            return control != nullptr;
+        }
+
+        bool validate() const
+        {
+            if (length < sizeof(Header))
+                return false;
+            const Header &h = header();
+            if (std::memcmp(h.magic, "SNP1", 4) != 0 || h.sectionCount != SECTION_COUNT)
+                return false;
+            size_t total = sizeof(Header);
+            for (size_t i = 0; i < SECTION_COUNT; ++i)
+                total += h.sectionSizes[i];
+            return total <= length;
+        }
+
+    public:
+        explicit Reader(const std::string &n) : name(n) {}
+
+        ~Reader()
+        {
+            release();
+            if (control)
+                ::munmap(const_cast<Control *>(control), sizeof(Control));
+        }
+
+        Reader(const Reader &) = delete;
+        Reader &operator=(const Reader &) = delete;
+
+        // Generasi terbaru yang diumumkan primary (0 jika belum ada)
+        uint64_t latestGeneration()
+        {
+            return attachControl() ? control->generation.load(std::memory_order_acquire) : 0;
+        }
+
+        // Apakah primary sudah menerbitkan generasi yang belum dimuat
+        bool hasNewGeneration()
+        {
+            uint64_t latest = latestGeneration();
+            return latest != 0 && latest != generation;
+        }
+
+        // Petakan generasi terbaru. false jika belum ada, atau segmennya sudah diganti generasi berikutnya
+        // sebelum sempat dibuka (coba lagi pada putaran berikutnya).
+        bool attachLatest()
+        {
+            uint64_t latest = latestGeneration();
+            if (latest == 0)
+                return false;
+            int fd = ::shm_open(segmentName(name, latest).c_str(), O_RDONLY, 0);
+            if (fd < 0)
+                return false;
+            struct stat st;
+            void *p = MAP_FAILED;
+            if (::fstat(fd, &st) == 0 && st.st_size > 0)
+                p = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd); // Mapping tetap valid setelah fd ditutup (dan setelah segmen di-unlink primary)
+            if (p == MAP_FAILED)
+                return false;
+            release();
+            data = static_cast<const char *>(p);
+            length = static_cast<size_t>(st.st_size);
+            generation = latest;
+            if (!validate())
+            {
+                release();
+                return false;
+            }
+            return true;
+        }
+
+        // Lepas mapping (mis. setelah isinya dimuat). Nomor generasi tetap diingat.
+        void release()
+        {
+            if (data)
+                ::munmap(const_cast<char *>(data), length);
+            data = nullptr;
+            length = 0;
+        }
+
+        bool isMapped() const { return data != nullptr; }
+        uint64_t getGeneration() const { return generation; }
+        const Header &header() const { return *reinterpret_cast<const Header *>(data); }
+
+        std::string_view section(Section s) const
+        {
+            const Header &h = header();
+            size_t offset = sizeof(Header);
+            for (int i = 0; i < s; ++i)
+                offset += h.sectionSizes[i];
+            return std::string_view(data + offset, h.sectionSizes[s]);
+        }
+
+        uint64_t primaryJournal() { return attachControl() ? control->primaryJournal.load(std::memory_order_relaxed) : 0; }
+        time_t primaryHeartbeat() { return attachControl() ? static_cast<time_t>(control->heartbeat.load(std::memory_order_acquire)) : 0; }
+    };
+};
+
+#endif // SHAREDSNAPSHOT_H
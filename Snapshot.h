@@ -0,0 +1,63 @@
+// File: Snapshot.h
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <memory>
+#include <ctime>
+#include <cstdint>
+#include <utility>
+#include "User.h"
+#include "Transaction.h"
+#include "DailyRollups.h"
+#include "ChangeTracker.h"
+
+// Salinan data Akun Bank yang diserialisasi (Id, OwnerId, Balance)
+struct AccountRecord
+{
+    Id accountId;
+    Id ownerId;
+    double balance;
+
+    std::string toString() const
+    {
+        return accountId + "," + ownerId + "," + std::to_string(balance);
+    }
+};
+
+// Pandangan (view) konsisten atas state Store & Bank pada satu posisi journal.
+// Diambil di thread pemilik state (hanya menyalin nilai), lalu diserialisasi di thread lain
+// sehingga pembelian tetap bisa berjalan selama file ditulis.
+struct StoreSnapshot
+{
+    uint64_t journalPosition = 0; // Perubahan ke-1..journalPosition sudah tercakup
+    time_t takenAt = 0;
+    std::vector<std::shared_ptr<const User>> users; // Klon Buyer/Seller (termasuk item)
+    std::vector<AccountRecord> accounts;
+    std::vector<Transaction> transactions;
+    DailyRollups::Days rollups;
+    ChangeTracker::Changes changes; // Perubahan yang tercakup; dikembalikan ke ChangeTracker jika penulisan gagal
+};
+
+// Isi snapshot read replica (termasuk cash flow, yang tidak disimpan di file snapshot). Server menyimpan
+// satu image yang diperbarui di background dari delta berbentuk sama: di barrier hanya record yang berubah
+// (ChangeTracker, DailyRollups::takeChanged) yang disalin ke delta.
+struct ReplicaImage
+{
+    bool complete = false; // Delta berisi seluruh state dan menggantikan image
+    uint64_t journalPosition = 0;
+    time_t takenAt = 0;
+    std::map<Id, std::shared_ptr<const User>> users; // UserId -> klon Buyer/Seller (termasuk item)
+    std::map<Id, AccountRecord> accounts;            // OwnerId -> akun
+    std::map<Id, Transaction> transactions;          // TId -> transaksi toko
+    DailyRollups::Days rollups;
+    std::set<int64_t> rollupDays;                                      // Delta: hari yang berubah (tidak ada di rollups = dihapus)
+    std::map<Id, std::vector<Transaction>> cashFlows;                  // OwnerId -> cash flow, BuyerID = pemilik
+    std::map<Id, std::vector<CashFlowCheckpoint>> cashFlowCheckpoints; // OwnerId -> checkpoint bulanan
+};
+
+#endif // SNAPSHOT_H
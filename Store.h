@@ -6,12 +6,26 @@
 #include <iostream>
 #include <vector>
 #include <map>
+#include <set>
+#include <unordered_map>
+#include <sstream>
+#include <string_view>
 #include <algorithm>
+#include <charconv>
 #include <numeric>
 #include <memory>
+#include <mutex>
 #include "Buyer.h"
 #include "Seller.h"
 #include "Bank.h"
+#include "Idempotency.h"
+#include "MemoryFootprint.h"
+#include "Metrics.h"
+#include "ItemSearchIndex.h"
+#include "Parallel.h"
+#include "PopularitySketch.h"
+#include "HyperLogLog.h"
+#include "DailyRollups.h"
 
 // Gunakan User dalam bentuk shared_ptr
 using UserPtr = std::shared_ptr<User>;
@@ -21,38 +35,214 @@ using SellerPtr = std::shared_ptr<Seller>;
 class Store
 {
 private:
-    std::map<std::string, UserPtr> users;                    // Map: UserId -> User (Buyer/Seller)
-    std::map<std::string, Transaction> allStoreTransactions; // Map: TId -> Transaction (Transaksi Pembelian)
+    std::map<Id, UserPtr> users;                    // Map: UserId -> User (Buyer/Seller)
+    std::map<Id, Transaction> allStoreTransactions; // Map: TId -> Transaction (Transaksi Pembelian)
+    std::map<TransactionStatus, std::set<Id>> ordersByStatus; // Index: Status -> TId (agar tidak scan seluruh ledger)
+    ItemSearchIndex itemIndex;                                         // Index nama item seluruh seller
+    std::unordered_map<Id, std::set<std::pair<double, Id>>> offersByItem; // ItemId -> (Harga, SellerId), hanya offer yang masih punya stok
+    PopularityTracker popularity;                                      // Sketch heavy-hitter, diperbarui per pembelian
+    CustomerReach customerReach;                                       // Sketch HLL buyer unik per seller & item
+    AnalyticsMode analyticsMode = AnalyticsMode::EXACT;
+
+    // Mode shard: thread shard hanya memiliki user/akun/katalog miliknya sendiri. Struktur bersama di atas
+    // (buku offer, ledger, index, sketch) dikunci sharedMtx saat diakses dari jalur pembelian shard.
+    std::mutex sharedMtx;
+    size_t lastTransactionNumber = 0; // Nomor ID transaksi toko terakhir yang sudah dialokasikan
 
     // Konsep Singleton
-    Store() = default;
+    Store()
+    {
+        // Gauge ukuran struktur data, dibaca saat metrics ditampilkan/diekspor
+        Metrics &metrics = Metrics::getInstance();
+        metrics.gauge("store_users", "Jumlah user terdaftar", [this]()
+                      { return static_cast<double>(users.size()); });
+        metrics.gauge("store_transactions", "Jumlah transaksi toko", [this]()
+                      { return static_cast<double>(allStoreTransactions.size()); });
+        metrics.gauge("store_orders", "Jumlah pesanan per status", [this]()
+                      { return static_cast<double>(countOrders(TransactionStatus::PAID)); }, "status=\"paid\"");
+        metrics.gauge("store_orders", "Jumlah pesanan per status", [this]()
+                      { return static_cast<double>(countOrders(TransactionStatus::COMPLETED)); }, "status=\"completed\"");
+        metrics.gauge("store_orders", "Jumlah pesanan per status", [this]()
+                      { return static_cast<double>(countOrders(TransactionStatus::CANCELLED)); }, "status=\"cancelled\"");
+        metrics.gauge("store_indexed_items", "Jumlah item di index pencarian", [this]()
+                      { return static_cast<double>(itemIndex.size()); });
+    }
     Store(const Store &) = delete;
     Store &operator=(const Store &) = delete;
 
-    // Helper untuk mencari penjual berdasarkan Item ID
-    SellerPtr findSellerByItemId(const std::string &itemId)
+    // Sinkronkan offer seller untuk sebuah item dengan stoknya: offer tanpa stok dikeluarkan dari buku,
+    // sehingga offer termurah yang masih bisa dibeli selalu ada di awal set.
+    void syncOffer(const Id &sellerId, const Item &item)
     {
-        for (auto const &pair : users)
+        std::pair<double, Id> key(item.getPrice(), sellerId);
+        if (item.getStock() > 0)
         {
-            if (auto seller = std::dynamic_pointer_cast<Seller>(pair.second))
+            offersByItem[item.getId()].insert(std::move(key));
+            return;
+        }
+        auto it = offersByItem.find(item.getId());
+        if (it == offersByItem.end())
+            return;
+        it->second.erase(key);
+        if (it->second.empty())
+            offersByItem.erase(it);
+    }
+
+    // Helper untuk mencari penjual berdasarkan User ID
+    SellerPtr findSellerById(const Id &sellerId) const
+    {
+        auto it = users.find(sellerId);
+        if (it == users.end())
+            return nullptr;
+        return std::dynamic_pointer_cast<Seller>(it->second);
+    }
+
+    size_t countOrders(TransactionStatus status) const
+    {
+        auto it = ordersByStatus.find(status);
+        return it == ordersByStatus.end() ? 0 : it->second.size();
+    }
+
+    // Bangun ulang index status dari seluruh ledger. Iterasi map sudah urut per ID,
+    // sehingga setiap insert ke set cukup memakai hint di akhir.
+    void rebuildOrderIndex()
+    {
+        ordersByStatus.clear();
+        for (const auto &pair : allStoreTransactions)
+        {
+            std::set<Id> &ids = ordersByStatus[pair.second.getStatus()];
+            ids.emplace_hint(ids.end(), pair.first);
+        }
+    }
+
+    // Helper untuk memindahkan status transaksi sekaligus menjaga index per status
+    void moveOrderStatus(Transaction &t, TransactionStatus newStatus)
+    {
+        ordersByStatus[t.getStatus()].erase(t.getId());
+        ordersByStatus[newStatus].insert(t.getId());
+        t.setStatus(newStatus);
+        ChangeTracker::getInstance().markTransaction(t.getId());
+        Journal::getInstance().advance();
+    }
+
+    // Pointer ke seluruh transaksi toko sesuai urutan ID, agar ledger bisa dipartisi untuk laporan paralel
+    std::vector<const Transaction *> ledgerView() const
+    {
+        std::vector<const Transaction *> ledger;
+        ledger.reserve(allStoreTransactions.size());
+        for (const auto &pair : allStoreTransactions)
+            ledger.push_back(&pair.second);
+        return ledger;
+    }
+
+    // Hitung transaksi non-CANCELLED per key (item/buyer/seller) secara paralel: setiap partisi ledger
+    // mengisi hash map lokal, lalu digabung ke map terurut sehingga hasilnya identik dengan versi serial
+    template <typename KeyFn>
+    std::map<Id, int> countActiveBy(KeyFn key) const
+    {
+        std::vector<const Transaction *> ledger = ledgerView();
+        auto partials = Parallel::mapRanges<std::unordered_map<Id, int>>(ledger.size(), [&](size_t begin, size_t end, std::unordered_map<Id, int> &local)
+                                                                           {
+            for (size_t i = begin; i < end; ++i)
             {
-                if (seller->getItem(itemId) != nullptr)
-                {
-                    return seller;
-                }
+                if (ledger[i]->getStatus() != TransactionStatus::CANCELLED)
+                    local[key(*ledger[i])]++;
+            } });
+
+        std::map<Id, int> merged;
+        for (const auto &local : partials)
+        {
+            for (const auto &pair : local)
+                merged[pair.first] += pair.second;
+        }
+        return merged;
+    }
+
+    // Cetak top-m dari sketch beserta rentang nilai sebenarnya [count - error, count].
+    // reachSince > 0 menambahkan perkiraan buyer unik per item milik reachSeller sejak waktu tersebut.
+    void printApproximateTop(const std::string &title, const SpaceSaving &sketch, int m, const std::string &label,
+                             const Id &reachSeller = Id(), time_t reachSince = 0) const
+    {
+        std::cout << title << std::endl;
+        std::vector<SpaceSaving::Counter> top = sketch.top(static_cast<size_t>(std::max(m, 0)));
+        for (size_t i = 0; i < top.size(); ++i)
+        {
+            std::cout << (i + 1) << ". Item ID: " << top[i].key
+                      << " | " << label << ": ~" << top[i].count;
+            if (top[i].error > 0)
+                std::cout << " (min " << top[i].count - top[i].error << ")";
+            if (reachSince > 0)
+                std::cout << " | Buyer Unik: ~" << customerReach.uniqueBuyersOfItem(reachSeller, top[i].key, reachSince);
+            std::cout << std::endl;
+        }
+        std::cout << "Total tercatat: " << sketch.getTotal() << " | Kapasitas sketch: " << sketch.getCapacity()
+                  << " (error maks per item <= total / kapasitas)" << std::endl;
+    }
+
+    // Transaksi toko dari luar (load, checkpoint, impor) bisa memakai nomor di atas jumlah transaksi
+    // (mis. S1 dan S3 saja). Nomor tertinggi "S<n>" dicatat agar allocateTransactionId tidak memakai ulang ID.
+    void noteTransactionId(const Id &tId)
+    {
+        std::string_view s = tId.view();
+        size_t number = 0;
+        if (s.size() < 2 || s.front() != 'S')
+            return;
+        auto res = std::from_chars(s.data() + 1, s.data() + s.size(), number);
+        if (res.ec == std::errc() && res.ptr == s.data() + s.size())
+            lastTransactionNumber = std::max(lastTransactionNumber, number);
+    }
+
+    // Tambah (sign = +1) atau tarik (sign = -1) transaksi dari rollup harian; pesanan batal tidak dihitung
+    static void applyRollup(const Transaction &t, int sign)
+    {
+        if (t.getStatus() != TransactionStatus::CANCELLED)
+            DailyRollups::getInstance().applyPurchase(t, sign);
+    }
+
+    // Panggil fn(SellerRollup) untuk setiap hari (sejak awal hari dari 'since') yang punya penjualan seller ini
+    template <typename Fn>
+    static void forEachSellerDay(const Id &sellerId, time_t since, Fn fn)
+    {
+        DailyRollups::getInstance().forEachDaySince(DailyRollups::dayOf(since), [&](int64_t, const DayRollup &day)
+                                                    {
+            auto it = day.sellers.find(sellerId);
+            if (it != day.sellers.end())
+                fn(it->second); });
+    }
+
+    // Helper untuk membatalkan pesanan: kembalikan dana ke buyer dan stok ke seller
+    bool reverseOrder(Transaction &t)
+    {
+        if (!Bank::getInstance().reverseTransfer(t.getBuyerId(), t.getSellerId(), t.getAmount(), Id::join("R_", t.getId())))
+        {
+            std::cout << "Gagal: Saldo seller " << t.getSellerId() << " tidak cukup untuk mengembalikan dana." << std::endl;
+            return false;
+        }
+
+        if (SellerPtr seller = findSellerById(t.getSellerId()))
+        {
+            if (Item *item = seller->getItem(t.getItemId()))
+            {
+                item->addStock(t.getQuantity());
+                seller->touchItem(t.getItemId());
+                syncOffer(seller->getId(), *item);
             }
         }
-        return nullptr;
+
+        popularity.unrecord(t.getSellerId(), t.getItemId(), t.getQuantity(), t.getDate());
+        DailyRollups::getInstance().applyPurchase(t, -1);
+        moveOrderStatus(t, TransactionStatus::CANCELLED);
+        return true;
     }
 
 public:
 
     // Getter untuk Serialisasi
-    const std::map<std::string, UserPtr>& getUsers() const {
+    const std::map<Id, UserPtr>& getUsers() const {
         return users;
     }
 
-    const std::map<std::string, Transaction>& getStoreTransactions() const {
+    const std::map<Id, Transaction>& getStoreTransactions() const {
         return allStoreTransactions;
     }
     // Metode akses Singleton
@@ -62,6 +252,254 @@ public:
         return instance;
     }
 
+    // --- Pemulihan Data (digunakan oleh DataPersistence saat load) ---
+    // Tidak mencetak ke konsol dan tidak mencatat ke journal karena data berasal dari disk.
+
+    // Kosongkan seluruh state, dipakai read replica sebelum memuat snapshot baru
+    void clear()
+    {
+        users.clear();
+        allStoreTransactions.clear();
+        ordersByStatus.clear();
+        itemIndex = ItemSearchIndex();
+        offersByItem.clear();
+        popularity.clear();
+        customerReach.clear();
+        lastTransactionNumber = 0;
+    }
+
+    // Daftarkan user hasil load (membuat akun bank jika belum ada). User lama dengan ID sama diganti.
+    void restoreUser(const UserPtr &user)
+    {
+        if (auto seller = std::dynamic_pointer_cast<Seller>(user))
+        {
+            for (const auto &pair : seller->getAllItems())
+            {
+                itemIndex.add(seller->getId(), pair.first, pair.second.getName());
+                syncOffer(seller->getId(), pair.second);
+            }
+        }
+
+        auto it = users.find(user->getId());
+        if (it != users.end())
+        {
+            user->setAccount(it->second->getAccount());
+            it->second = user;
+            return;
+        }
+        // users.dat ditulis berurutan sesuai key, jadi hint di akhir map membuat insert O(1)
+        users.emplace_hint(users.end(), user->getId(), user);
+        BankAccountPtr account = Bank::getInstance().getAccount(user->getId());
+        user->setAccount(account ? account : Bank::getInstance().createAccount(user->getId()));
+    }
+
+    // Pulihkan satu item milik seller (mis. dari log checkpoint) sekaligus memperbarui index pencarian
+    void restoreItem(const SellerPtr &seller, const Item &item)
+    {
+        seller->restoreItem(item);
+        itemIndex.add(seller->getId(), item.getId(), item.getName());
+        syncOffer(seller->getId(), item);
+    }
+
+    // Masukkan transaksi hasil load; transaksi dengan ID sama diganti (mis. status terbaru dari checkpoint)
+    void restoreTransaction(Transaction t)
+    {
+        Id tId = t.getId();
+        TransactionStatus status = t.getStatus();
+        noteTransactionId(tId);
+        auto res = allStoreTransactions.try_emplace(tId, std::move(t));
+        if (!res.second)
+        {
+            ordersByStatus[res.first->second.getStatus()].erase(tId);
+            res.first->second = std::move(t); // try_emplace tidak memindahkan t jika key sudah ada
+        }
+        ordersByStatus[status].insert(tId);
+    }
+
+    // Seperti restoreTransaction, tetapi rollup harian ikut disesuaikan dengan selisih versi lama
+    // dan baru (untuk data yang lebih baru dari rollup tersimpan, mis. log checkpoint & generator)
+    void replayTransaction(Transaction t)
+    {
+        auto it = allStoreTransactions.find(t.getId());
+        if (it != allStoreTransactions.end())
+            applyRollup(it->second, -1);
+        applyRollup(t, +1);
+        restoreTransaction(std::move(t));
+    }
+
+    // Impor massal transaksi toko historis. Batch diurutkan per ID agar insert ke map berurutan,
+    // lalu index status dan daftar order buyer dibangun sekali di akhir (bukan per insert).
+    // Transaksi dengan ID yang sudah ada ditolak (order yang hidup tidak ditimpa, karena dana dan stoknya
+    // tidak bisa dibalik dari sini). Mengembalikan jumlah transaksi yang dimasukkan.
+    size_t importTransactions(std::vector<Transaction> &&batch)
+    {
+        std::vector<std::pair<Id, size_t>> order; // (ID, posisi di batch)
+        order.reserve(batch.size());
+        for (size_t i = 0; i < batch.size(); ++i)
+            order.emplace_back(batch[i].getId(), i);
+        std::sort(order.begin(), order.end());
+
+        std::unordered_map<Id, std::vector<Id>> newOrders; // BuyerId -> order baru
+        size_t added = 0;
+        for (auto &entry : order)
+        {
+            Transaction &t = batch[entry.second];
+            noteTransactionId(entry.first);
+            auto pos = allStoreTransactions.lower_bound(entry.first); // Satu pencarian untuk cek duplikat + posisi insert
+            if (pos != allStoreTransactions.end() && pos->first == entry.first)
+                continue;
+            applyRollup(t, +1);
+            newOrders[t.getBuyerId()].push_back(entry.first);
+            allStoreTransactions.emplace_hint(pos, std::move(entry.first), std::move(t));
+            added++;
+        }
+
+        for (auto &pair : newOrders)
+        {
+            auto it = users.find(pair.first);
+            if (it != users.end())
+            {
+                if (BuyerPtr buyer = std::dynamic_pointer_cast<Buyer>(it->second))
+                    buyer->appendOrderIds(std::move(pair.second));
+            }
+        }
+
+        rebuildOrderIndex();
+        rebuildSketches();
+        return added;
+    }
+
+    // --- Katalog Item ---
+
+    // Registrasi item lewat Store agar index pencarian ikut diperbarui.
+    // Gagal jika ID terlalu panjang atau seller sudah punya item dengan ID yang sama.
+    bool registerItem(const SellerPtr &seller, const std::string &itemId, const std::string &name, double price, int stock)
+    {
+        if (!Id::fits(itemId))
+        {
+            std::cout << "Error: ID item maksimal " << Id::CAPACITY << " karakter." << std::endl;
+            return false;
+        }
+        if (seller->getItem(itemId))
+        {
+            std::cout << "Error: Item '" << itemId << "' sudah terdaftar." << std::endl;
+            return false;
+        }
+        seller->registerNewItem(itemId, name, price, stock);
+        Item *item = seller->getItem(itemId);
+        itemIndex.add(seller->getId(), itemId, item->getName());
+        syncOffer(seller->getId(), *item);
+        return true;
+    }
+
+    // Perubahan stok oleh seller lewat Store agar buku offer tetap sinkron
+    bool replenishStock(const SellerPtr &seller, const Id &itemId, int quantity)
+    {
+        if (!seller->replenishStock(itemId, quantity))
+            return false;
+        syncOffer(seller->getId(), *seller->getItem(itemId));
+        return true;
+    }
+
+    bool discardStock(const SellerPtr &seller, const Id &itemId, int quantity)
+    {
+        if (!seller->discardStock(itemId, quantity))
+            return false;
+        syncOffer(seller->getId(), *seller->getItem(itemId));
+        return true;
+    }
+
+    // Tampilkan semua offer untuk sebuah item, termurah lebih dulu
+    void listOffers(const Id &itemId) const
+    {
+        std::cout << "\n--- Offer untuk Item " << itemId << " ---" << std::endl;
+        auto it = offersByItem.find(itemId);
+        if (it == offersByItem.end())
+        {
+            std::cout << "Tidak ada seller dengan stok untuk item ini." << std::endl;
+            return;
+        }
+        for (const auto &offer : it->second)
+        {
+            SellerPtr seller = findSellerById(offer.second);
+            const Item *item = seller ? seller->getItem(itemId) : nullptr;
+            if (!item)
+                continue;
+            std::cout << "Seller: " << offer.second
+                      << " | Harga: " << offer.first
+                      << " | Stok: " << item->getStock() << std::endl;
+        }
+    }
+
+    // Cari item berdasarkan nama di seluruh seller, ditampilkan per halaman (page dimulai dari 1)
+    void searchItems(const std::string &query, size_t page, size_t pageSize) const
+    {
+        static Metrics::Histogram &latency = Metrics::getInstance().histogram("store_search_items_seconds", "Latensi pencarian item");
+        std::vector<const ItemSearchIndex::Entry *> results;
+        size_t total;
+        bool complete;
+        {
+            Metrics::ScopedTimer timer(latency);
+            total = itemIndex.search(query, (page - 1) * pageSize, pageSize, results, complete);
+        }
+
+        size_t pages = std::max<size_t>((total + pageSize - 1) / pageSize, 1);
+        std::cout << "\n--- Hasil Pencarian '" << query << "' (" << total << (complete ? "" : "+") << " item, halaman "
+                  << page << "/" << pages << (complete ? "" : "+") << ") ---" << std::endl;
+        if (results.empty())
+        {
+            std::cout << "Tidak ada item yang cocok." << std::endl;
+            return;
+        }
+        for (const ItemSearchIndex::Entry *entry : results)
+        {
+            SellerPtr seller = findSellerById(entry->sellerId);
+            const Item *item = seller ? seller->getItem(entry->itemId) : nullptr;
+            if (!item)
+                continue;
+            std::cout << "Item ID: " << entry->itemId
+                      << " | Nama: " << entry->name
+                      << " | Seller: " << entry->sellerId
+                      << " | Harga: " << item->getPrice()
+                      << " | Stok: " << item->getStock() << std::endl;
+        }
+    }
+
+    // Bangun ulang sketch popularitas & buyer unik dari ledger (setelah load/impor massal, bukan per insert)
+    void rebuildSketches()
+    {
+        popularity.clear();
+        customerReach.clear();
+        time_t windowStart = DateUtility::getPastDays(CustomerReach::WINDOW_DAYS);
+        for (const auto &pair : allStoreTransactions)
+        {
+            const Transaction &t = pair.second;
+            if (t.getStatus() != TransactionStatus::CANCELLED)
+                popularity.record(t.getSellerId(), t.getItemId(), t.getQuantity(), t.getDate());
+            if (t.getDate() >= windowStart)
+                customerReach.record(t.getSellerId(), t.getItemId(), t.getBuyerId(), t.getDate());
+        }
+    }
+
+    // Bangun ulang bagian toko dari rollup harian berdasarkan ledger (jika file rollup belum ada)
+    void rebuildRollups()
+    {
+        DailyRollups::getInstance().clearPurchases();
+        for (const auto &pair : allStoreTransactions)
+            applyRollup(pair.second, +1);
+    }
+
+    AnalyticsMode getAnalyticsMode() const
+    {
+        return analyticsMode;
+    }
+
+    void setAnalyticsMode(AnalyticsMode mode)
+    {
+        analyticsMode = mode;
+        Bank::getInstance().setAnalyticsMode(mode);
+    }
+
     // --- Manajemen Pengguna (Register & Login) ---
 
     // Register User (Buyer/Seller)
@@ -77,7 +515,7 @@ public:
             }
         }
 
-        std::string newId = "U" + std::to_string(users.size() + 1);
+        Id newId = Id::numbered("U", users.size() + 1);
         UserPtr newUser;
 
         if (isSeller)
@@ -95,6 +533,8 @@ public:
         // 2. Buat Akun Bank dan hubungkan ke User
         auto bankAccount = Bank::getInstance().createAccount(newId);
         newUser->setAccount(bankAccount);
+        newUser->markDirty();
+        Journal::getInstance().advance();
 
         std::cout << "Registrasi " << (isSeller ? "Seller" : "Buyer") << " berhasil. User ID: " << newId << std::endl;
         return true;
@@ -103,80 +543,330 @@ public:
     // Login (Mengembalikan UserPtr jika berhasil)
     UserPtr login(const std::string &username, const std::string &password)
     {
+        static Metrics::Histogram &latency = Metrics::getInstance().histogram("store_login_seconds", "Latensi Store::login");
+        static Metrics::Counter &loginOk = Metrics::getInstance().counter("store_login_total", "Jumlah login per hasil", "result=\"ok\"");
+        static Metrics::Counter &loginFailed = Metrics::getInstance().counter("store_login_total", "Jumlah login per hasil", "result=\"failed\"");
+        Metrics::ScopedTimer timer(latency);
+
         for (const auto &pair : users)
         {
             if (pair.second->getUsername() == username && pair.second->verifyPassword(password))
             {
+                loginOk.increment();
                 std::cout << "Login berhasil! Selamat datang, " << username << "." << std::endl;
                 return pair.second;
             }
         }
+        loginFailed.increment();
         std::cout << "Login gagal: Username atau password salah." << std::endl;
         return nullptr;
     }
 
     // --- Fungsionalitas Toko (Pembelian) ---
 
-    // Purchase item
-    bool purchaseItem(UserPtr buyer, const std::string &itemId, int quantity)
+    // Purchase item: dibeli dari offer termurah yang masih punya stok, dipecah ke beberapa seller
+    // (satu transaksi toko per seller) jika satu seller tidak cukup.
+    // idempotencyKey (opsional, dari client): retry dengan kunci yang sama mengembalikan hasil pertama
+    // tanpa menyentuh stok atau saldo.
+    bool purchaseItem(UserPtr buyer, const Id &itemId, int quantity, const std::string &idempotencyKey = "")
     {
-        if (!buyer)
+        if (idempotencyKey.empty() || !buyer)
+            return purchaseItemTo(std::cout, buyer, itemId, quantity);
+
+        std::string key = Idempotency::scopedKey(buyer->getId(), idempotencyKey);
+        std::string request = Idempotency::requestOf("PURCHASE", std::string(itemId) + " " + std::to_string(quantity));
+        Idempotency::Result previous;
+        switch (Idempotency::getInstance().begin(key, request, previous))
+        {
+        case Idempotency::Status::REPLAY:
+            std::cout << previous.body;
+            return previous.ok;
+        case Idempotency::Status::IN_PROGRESS:
+            std::cout << "Pembelian dengan kunci ini masih diproses." << std::endl;
             return false;
+        case Idempotency::Status::CONFLICT:
+            std::cout << "Error: Idempotency key sudah dipakai untuk permintaan lain." << std::endl;
+            return false;
+        case Idempotency::Status::NEW:
+            break;
+        }
+        std::ostringstream out;
+        bool ok = purchaseItemTo(out, buyer, itemId, quantity);
+        std::cout << out.str();
+        Idempotency::getInstance().finish(key, {ok, out.str()});
+        return ok;
+    }
 
-        SellerPtr seller = findSellerByItemId(itemId);
-        if (!seller)
+    // Isi purchaseItem; pesan untuk user ditulis ke 'out'
+    bool purchaseItemTo(std::ostream &out, UserPtr buyer, const Id &itemId, int quantity)
+    {
+        static Metrics::Histogram &latency = Metrics::getInstance().histogram("store_purchase_seconds", "Latensi Store::purchaseItem");
+        static Metrics::Counter &purchaseOk = Metrics::getInstance().counter("store_purchase_total", "Jumlah pembelian per hasil", "result=\"ok\"");
+        static Metrics::Counter &insufficientBalance = Metrics::getInstance().counter("store_purchase_total", "Jumlah pembelian per hasil", "result=\"insufficient_balance\"");
+        Metrics::ScopedTimer timer(latency);
+
+        if (!buyer || quantity <= 0)
+            return false;
+
+        // 1. Reservasi stok dari offer termurah, dipecah ke beberapa seller jika perlu
+        std::vector<PurchaseLeg> legs;
+        std::string error;
+        if (!reserveLegs(itemId, quantity, legs, error))
         {
-            std::cout << "Pembelian gagal: Item tidak ditemukan." << std::endl;
+            out << error << std::endl;
             return false;
         }
+        double totalAmount = 0.0;
+        for (const PurchaseLeg &leg : legs)
+            totalAmount += leg.amount;
 
-        Item *item = seller->getItem(itemId);
-        if (item->getStock() < quantity)
+        auto releaseFrom = [&legs](size_t first)
+        {
+            for (size_t i = first; i < legs.size(); ++i)
+                legs[i].item->releaseReservation(legs[i].quantity);
+        };
+
+        // 2. Cek saldo untuk seluruh pembelian sebelum ada dana yang berpindah
+        BankAccountPtr buyerAccount = Bank::getInstance().getAccount(buyer->getId());
+        if (!buyerAccount || buyerAccount->getBalance() < totalAmount)
+        {
+            releaseFrom(0);
+            insufficientBalance.increment();
+            out << "Pembelian gagal: Saldo tidak cukup di akun buyer." << std::endl;
+            return false;
+        }
+
+        // 3. Per seller: transfer dana, reservasi menjadi permanen, catat transaksi toko (status PAID)
+        auto buyerPtr = std::dynamic_pointer_cast<Buyer>(buyer);
+        double paid = 0.0;
+        for (size_t i = 0; i < legs.size(); ++i)
+        {
+            PurchaseLeg &leg = legs[i];
+            leg.transactionId = allocateTransactionId();
+            const Id &tId = leg.transactionId;
+            if (!Bank::getInstance().transfer(buyer->getId(), leg.seller->getId(), leg.amount, tId))
+            {
+                releaseFrom(i); // Kembalikan stok yang belum dibayar
+                insufficientBalance.increment();
+                out << "Pembelian terhenti: Saldo tidak cukup. Terbayar: " << paid << std::endl;
+                return false;
+            }
+            if (!commitLeg(buyer->getId(), itemId, leg))
+            {
+                releaseFrom(i + 1);
+                out << "Pembelian terhenti: ID transaksi " << tId << " bentrok. Terbayar: " << paid + leg.amount << std::endl;
+                return false;
+            }
+
+            // Tambahkan ID Order ke Buyer
+            if (buyerPtr)
+            {
+                buyerPtr->addOrderId(tId);
+            }
+            else
+            {
+                // Ini seharusnya tidak terjadi jika 'buyer' adalah Buyer atau Seller
+                std::cerr << "Error: Gagal melakukan downcast user ke Buyer." << std::endl;
+            }
+            paid += leg.amount;
+            out << "  " << tId << ": " << leg.quantity << " x " << leg.item->getPrice()
+                 << " dari seller " << leg.seller->getId() << std::endl;
+        }
+
+        purchaseOk.increment();
+        out << "Pembelian item '" << legs.front().item->getName() << "' berhasil. Total: " << totalAmount << std::endl;
+        return true;
+    }
+
+    // --- Tahapan Pembelian (dipakai purchaseItem dan jalur shard di ShardEngine) ---
+    // Aman dipanggil dari thread shard: struktur bersama dikunci sharedMtx, stok item memakai CAS.
+
+    struct PurchaseLeg
+    {
+        SellerPtr seller;
+        Item *item;
+        int quantity;
+        double amount;
+        Id transactionId; // Diisi saat dana dipindahkan
+        Ledger::Position payment = 0; // Entri Ledger pembayaran (jalur shard, diisi Bank::prepareTransfer)
+    };
+
+    // Reservasi stok dari offer termurah (dipecah ke beberapa seller jika perlu).
+    // Gagal jika stok total tidak cukup; reservasi yang sudah dibuat dilepas dan error berisi pesan untuk user.
+    bool reserveLegs(const Id &itemId, int quantity, std::vector<PurchaseLeg> &legs, std::string &error)
+    {
+        static Metrics::Counter &itemNotFound = Metrics::getInstance().counter("store_purchase_total", "Jumlah pembelian per hasil", "result=\"item_not_found\"");
+        static Metrics::Counter &insufficientStock = Metrics::getInstance().counter("store_purchase_total", "Jumlah pembelian per hasil", "result=\"insufficient_stock\"");
+
+        std::lock_guard<std::mutex> lock(sharedMtx);
+        auto book = offersByItem.find(itemId);
+        if (book == offersByItem.end())
         {
-            std::cout << "Pembelian gagal: Stok item (" << item->getName() << ") tidak cukup. Sisa: " << item->getStock() << std::endl;
+            itemNotFound.increment();
+            error = "Pembelian gagal: Item tidak ditemukan atau stok habis di semua seller.";
             return false;
         }
 
-        double totalAmount = item->getPrice() * quantity;
-        std::string tId = "S" + std::to_string(allStoreTransactions.size() + 1);
+        int remaining = quantity;
+        for (const auto &offer : book->second)
+        {
+            if (remaining == 0)
+                break;
+            SellerPtr seller = findSellerById(offer.second);
+            Item *item = seller ? seller->getItem(itemId) : nullptr;
+            if (!item)
+                continue;
+            int take = std::min(remaining, item->getStock());
+            if (take <= 0 || !item->reserveStock(take))
+                continue;
+            legs.push_back({seller, item, take, item->getPrice() * take, Id()});
+            remaining -= take;
+        }
 
-        // 1. Cek Saldo dan Transfer Dana (rely on banking)
-        if (!Bank::getInstance().transfer(buyer->getId(), seller->getId(), totalAmount, tId))
+        if (remaining > 0)
         {
-            std::cout << "Pembelian gagal: Saldo tidak cukup di akun buyer." << std::endl;
+            releaseLegs(legs);
+            legs.clear();
+            insufficientStock.increment();
+            error = "Pembelian gagal: Stok item tidak cukup. Tersedia di semua seller: " + std::to_string(quantity - remaining);
             return false;
         }
+        return true;
+    }
+
+    static void releaseLegs(const std::vector<PurchaseLeg> &legs)
+    {
+        for (const PurchaseLeg &leg : legs)
+            leg.item->releaseReservation(leg.quantity);
+    }
 
-        // 2. Kurangi Stok Penjual
-        seller->discardStock(itemId, quantity);
+    // ID transaksi toko baru (purchaseItem dan jalur shard): dialokasikan sebelum dana berpindah (dipakai di
+    // cash flow), sementara transaksinya baru tercatat saat commitLeg, jadi ukuran ledger saja tidak cukup.
+    Id allocateTransactionId()
+    {
+        std::lock_guard<std::mutex> lock(sharedMtx);
+        lastTransactionNumber = std::max(lastTransactionNumber, allStoreTransactions.size()) + 1;
+        return Id::numbered("S", lastTransactionNumber);
+    }
 
-        // 3. Catat Transaksi Toko (default status: PAID, karena sudah dibayar)
-        Transaction newTransaction(tId, itemId, buyer->getId(), seller->getId(), totalAmount, quantity);
-        allStoreTransactions.emplace(tId, std::move(newTransaction));
+    // Setelah dana dibayar: reservasi menjadi permanen dan transaksi toko dicatat (status PAID).
+    // Di mode shard dipanggil di thread shard milik seller. Gagal (reservasi dilepas, transaksi lama tidak
+    // disentuh) jika ID transaksi sudah dipakai; seharusnya tidak terjadi karena ID berasal dari allocateTransactionId.
+    bool commitLeg(const Id &buyerId, const Id &itemId, const PurchaseLeg &leg)
+    {
+        static Metrics::Counter &conflicts = Metrics::getInstance().counter("store_transaction_id_conflict_total", "Jumlah transaksi toko yang ditolak karena ID sudah dipakai");
 
-        // 4. Tambahkan ID Order ke Buyer
-        if (auto buyerPtr = std::dynamic_pointer_cast<Buyer>(buyer))
+        Transaction newTransaction(leg.transactionId, itemId, buyerId, leg.seller->getId(), leg.amount, leg.quantity);
+        std::lock_guard<std::mutex> lock(sharedMtx);
+        if (allStoreTransactions.count(leg.transactionId))
         {
-            buyerPtr->addOrderId(tId);
+            leg.item->releaseReservation(leg.quantity);
+            conflicts.increment();
+            std::cerr << "Error: ID transaksi " << leg.transactionId << " sudah dipakai, transaksi tidak dicatat." << std::endl;
+            return false;
         }
-        else
+        leg.item->commitReservation(leg.quantity);
+        leg.seller->touchItem(itemId);
+        syncOffer(leg.seller->getId(), *leg.item);
+        popularity.record(leg.seller->getId(), itemId, leg.quantity, newTransaction.getDate());
+        customerReach.record(leg.seller->getId(), itemId, buyerId, newTransaction.getDate());
+        DailyRollups::getInstance().applyPurchase(newTransaction, +1);
+        allStoreTransactions.emplace(leg.transactionId, std::move(newTransaction));
+        ordersByStatus[TransactionStatus::PAID].insert(leg.transactionId);
+        ChangeTracker::getInstance().markTransaction(leg.transactionId);
+        Journal::getInstance().advance();
+        return true;
+    }
+
+    // --- Siklus Status Pesanan (PAID -> COMPLETED / CANCELLED) ---
+
+    // Tandai pesanan PAID sebagai selesai
+    bool completeOrder(const Id &tId)
+    {
+        auto it = allStoreTransactions.find(tId);
+        if (it == allStoreTransactions.end() || it->second.getStatus() != TransactionStatus::PAID)
         {
-            // Ini seharusnya tidak terjadi jika 'buyer' adalah Buyer atau Seller
-            std::cerr << "Error: Gagal melakukan downcast user ke Buyer." << std::endl;
+            std::cout << "Gagal: Pesanan " << tId << " tidak ditemukan atau bukan berstatus PAID." << std::endl;
+            return false;
+        }
+        moveOrderStatus(it->second, TransactionStatus::COMPLETED);
+        std::cout << "Pesanan " << tId << " selesai (COMPLETED)." << std::endl;
+        return true;
+    }
+
+    // Selesaikan banyak pesanan sekaligus (batch), mengembalikan jumlah yang berhasil
+    int completeOrders(const std::vector<Id> &tIds)
+    {
+        std::set<Id> &paid = ordersByStatus[TransactionStatus::PAID];
+        std::set<Id> &completed = ordersByStatus[TransactionStatus::COMPLETED];
+        int count = 0;
+        for (const Id &tId : tIds)
+        {
+            auto node = paid.extract(tId); // Pindahkan node tanpa alokasi ulang
+            if (node.empty())
+                continue;
+            allStoreTransactions.at(tId).setStatus(TransactionStatus::COMPLETED);
+            ChangeTracker::getInstance().markTransaction(tId);
+            completed.insert(std::move(node));
+            count++;
         }
+        Journal::getInstance().advance(count);
+        return count;
+    }
 
-        std::cout << "Pembelian item '" << item->getName() << "' berhasil. Total: " << totalAmount << std::endl;
+    // Selesaikan semua pesanan yang masih PAID, biaya O(pesanan terbuka)
+    int completeAllPaidOrders()
+    {
+        std::set<Id> &paid = ordersByStatus[TransactionStatus::PAID];
+        for (const Id &tId : paid)
+        {
+            allStoreTransactions.at(tId).setStatus(TransactionStatus::COMPLETED);
+            ChangeTracker::getInstance().markTransaction(tId);
+        }
+        int count = static_cast<int>(paid.size());
+        ordersByStatus[TransactionStatus::COMPLETED].merge(paid);
+        Journal::getInstance().advance(count);
+        return count;
+    }
+
+    // Batalkan pesanan yang belum selesai (PAID): dana dikembalikan, stok dipulihkan
+    bool cancelOrder(const Id &tId)
+    {
+        auto it = allStoreTransactions.find(tId);
+        if (it == allStoreTransactions.end() || it->second.getStatus() != TransactionStatus::PAID)
+        {
+            std::cout << "Gagal: Pesanan " << tId << " tidak ditemukan atau bukan berstatus PAID." << std::endl;
+            return false;
+        }
+        if (!reverseOrder(it->second))
+            return false;
+        std::cout << "Pesanan " << tId << " dibatalkan. Dana dikembalikan ke buyer." << std::endl;
+        return true;
+    }
+
+    // Refund pesanan yang sudah selesai (COMPLETED): dana dikembalikan, stok dipulihkan
+    bool refundOrder(const Id &tId)
+    {
+        auto it = allStoreTransactions.find(tId);
+        if (it == allStoreTransactions.end() || it->second.getStatus() != TransactionStatus::COMPLETED)
+        {
+            std::cout << "Gagal: Pesanan " << tId << " tidak ditemukan atau bukan berstatus COMPLETED." << std::endl;
+            return false;
+        }
+        if (!reverseOrder(it->second))
+            return false;
+        std::cout << "Pesanan " << tId << " di-refund. Dana dikembalikan ke buyer." << std::endl;
         return true;
     }
 
     // List all orders (filter by paid/canceled/completed) - Untuk Buyer/Seller
-    void listOrders(const std::vector<std::string> &orderIds, TransactionStatus filter) const
+    void listOrders(const std::vector<Id> &orderIds, TransactionStatus filter) const
     {
         std::cout << "\n--- Daftar Pesanan (" << (filter == TransactionStatus::PAID ? "PAID" : filter == TransactionStatus::COMPLETED ? "COMPLETED"
                                                                                                                                       : "CANCELLED")
                   << ") ---" << std::endl;
         int count = 0;
-        for (const std::string &tId : orderIds)
+        for (const Id &tId : orderIds)
         {
             if (allStoreTransactions.count(tId) && allStoreTransactions.at(tId).getStatus() == filter)
             {
@@ -213,14 +903,26 @@ public:
             return;
         }
 
-        // Gunakan buyerPtr yang sudah di-cast untuk mengakses getOrderIds()
-        const std::vector<std::string> &orderIds = buyerPtr->getOrderIds();
-
         time_t kDaysAgo = DateUtility::getPastDays(k);
         double totalSpending = 0.0;
 
+        if (analyticsMode == AnalyticsMode::ROLLUP)
+        {
+            DailyRollups::getInstance().forEachDaySince(DailyRollups::dayOf(kDaysAgo), [&](int64_t, const DayRollup &day)
+                                                        {
+                auto it = day.buyers.find(buyer->getId());
+                if (it != day.buyers.end())
+                    totalSpending += it->second.amount; });
+            std::cout << "\n--- Total Pengeluaran Buyer " << buyer->getUsername() << " dalam " << k
+                      << " hari terakhir (rollup harian): " << totalSpending << " ---" << std::endl;
+            return;
+        }
+
+        // Gunakan buyerPtr yang sudah di-cast untuk mengakses getOrderIds()
+        const std::vector<Id> &orderIds = buyerPtr->getOrderIds();
+
         // Ganti buyer->getOrderIds() dengan orderIds yang sudah di-cast
-        for (const std::string &tId : orderIds)
+        for (const Id &tId : orderIds)
         {
             if (allStoreTransactions.count(tId))
             {
@@ -237,6 +939,54 @@ public:
 
     // ... (kode selanjutnya)
 
+    // --- Pemakaian Memori ---
+
+    // Perkiraan memori struktur utama Store & Bank, satu baris per struktur (menu management / REPORT MEMORY).
+    // Dipanggil saat tidak ada operasi lain yang berjalan.
+    MemoryFootprint::Report memoryUsage() const
+    {
+        using MF = MemoryFootprint;
+        MF::Report report;
+
+        MF::Usage userUsage{"store.users", users.size(), 0};
+        MF::Usage itemUsage{"store.seller_items", 0, 0};
+        for (const auto &pair : users)
+        {
+            userUsage.bytes += MF::treeNode<std::pair<const Id, UserPtr>>() + pair.second->memoryBytes();
+            if (auto seller = std::dynamic_pointer_cast<Seller>(pair.second))
+            {
+                itemUsage.elements += seller->getAllItems().size();
+                itemUsage.bytes += seller->itemMemoryBytes();
+            }
+        }
+
+        MF::Usage transactionUsage{"store.transactions", allStoreTransactions.size(),
+                                   allStoreTransactions.size() * MF::treeNode<std::pair<const Id, Transaction>>()};
+
+        MF::Usage statusUsage{"store.orders_by_status", 0, 0};
+        for (const auto &pair : ordersByStatus)
+        {
+            statusUsage.bytes += MF::treeNode<std::pair<const TransactionStatus, std::set<Id>>>() + pair.second.size() * MF::treeNode<Id>();
+            statusUsage.elements += pair.second.size();
+        }
+
+        MF::Usage offerUsage{"store.offers_by_item", 0, MF::buckets(offersByItem)};
+        for (const auto &pair : offersByItem)
+        {
+            offerUsage.bytes += MF::hashNode<std::pair<const Id, std::set<std::pair<double, Id>>>>() +
+                                pair.second.size() * MF::treeNode<std::pair<double, Id>>();
+            offerUsage.elements += pair.second.size();
+        }
+
+        report.push_back(userUsage);
+        report.push_back(itemUsage);
+        report.push_back(transactionUsage);
+        report.push_back(statusUsage);
+        report.push_back(offerUsage);
+        Bank::getInstance().memoryUsage(report);
+        return report;
+    }
+
     // --- Fungsionalitas Listing Toko ---
 
     // 1. List all transactions of the latest k days
@@ -245,52 +995,64 @@ public:
         time_t kDaysAgo = DateUtility::getPastDays(k);
         std::cout << "\n--- Transaksi Toko " << k << " Hari Terakhir ---" << std::endl;
 
-        for (const auto &pair : allStoreTransactions)
-        {
-            const auto &t = pair.second;
-            if (t.getDate() >= kDaysAgo)
+        // Filter & format per partisi secara paralel, lalu cetak berurutan (urutan sama dengan versi serial)
+        std::vector<const Transaction *> ledger = ledgerView();
+        auto parts = Parallel::mapRanges<std::ostringstream>(ledger.size(), [&](size_t begin, size_t end, std::ostringstream &out)
+                                                             {
+            for (size_t i = begin; i < end; ++i)
             {
-                std::cout << "TID: " << t.getId() << " | Item: " << t.getItemId()
-                          << " | Buyer: " << t.getBuyerId()
-                          << " | Amount: " << t.getAmount()
-                          << " | Status: " << (t.getStatus() == TransactionStatus::PAID ? "PAID" : t.getStatus() == TransactionStatus::COMPLETED ? "COMPLETED"
-                                                                                                                                                 : "CANCELLED")
-                          << " | Date: " << DateUtility::timeToString(t.getDate()) << std::endl;
-            }
+                const auto &t = *ledger[i];
+                if (t.getDate() >= kDaysAgo)
+                {
+                    out << "TID: " << t.getId() << " | Item: " << t.getItemId()
+                        << " | Buyer: " << t.getBuyerId()
+                        << " | Amount: " << t.getAmount()
+                        << " | Status: " << (t.getStatus() == TransactionStatus::PAID ? "PAID" : t.getStatus() == TransactionStatus::COMPLETED ? "COMPLETED"
+                                                                                                                                             : "CANCELLED")
+                        << " | Date: " << DateUtility::timeToString(t.getDate()) << "\n";
+                }
+            } });
+        for (const auto &part : parts)
+        {
+            std::cout << part.str();
         }
+        std::cout.flush();
     }
 
     // 2. List all paid transaction but yet to be completed
     void listPaidUncompletedTransactions() const
     {
         std::cout << "\n--- Transaksi Dibayar Tetapi Belum Selesai ---" << std::endl;
-        for (const auto &pair : allStoreTransactions)
+        auto paid = ordersByStatus.find(TransactionStatus::PAID);
+        if (paid == ordersByStatus.end())
+            return;
+
+        // Hanya iterasi index PAID, bukan seluruh ledger
+        for (const Id &tId : paid->second)
         {
-            const auto &t = pair.second;
-            if (t.getStatus() == TransactionStatus::PAID)
-            {
-                std::cout << "TID: " << t.getId() << " | Item: " << t.getItemId()
-                          << " | Buyer: " << t.getBuyerId()
-                          << " | Seller: " << t.getSellerId()
-                          << " | Amount: " << t.getAmount() << std::endl;
-            }
+            const auto &t = allStoreTransactions.at(tId);
+            std::cout << "TID: " << t.getId() << " | Item: " << t.getItemId()
+                      << " | Buyer: " << t.getBuyerId()
+                      << " | Seller: " << t.getSellerId()
+                      << " | Amount: " << t.getAmount() << std::endl;
         }
     }
 
     // 3. List all most m frequent item transactions
     void listMostFrequentItems(int m) const
     {
-        std::map<std::string, int> itemFrequency;
-        for (const auto &pair : allStoreTransactions)
+        if (analyticsMode == AnalyticsMode::APPROXIMATE)
         {
-            if (pair.second.getStatus() != TransactionStatus::CANCELLED)
-            {
-                itemFrequency[pair.second.getItemId()]++;
-            }
+            printApproximateTop("\n--- Top " + std::to_string(m) + " Item Transaksi Paling Sering (Perkiraan) ---",
+                                popularity.storeAllTime(), m, "Frekuensi");
+            return;
         }
 
+        std::map<Id, int> itemFrequency = countActiveBy([](const Transaction &t) -> const Id &
+                                                              { return t.getItemId(); });
+
         // Konversi ke vektor pasangan (frequency, itemId) untuk sorting
-        std::vector<std::pair<int, std::string>> sortedItems;
+        std::vector<std::pair<int, Id>> sortedItems;
         for (const auto &pair : itemFrequency)
         {
             sortedItems.push_back({pair.second, pair.first});
@@ -311,16 +1073,10 @@ public:
         // Logika kompleks 'per hari' akan kita sederhanakan menjadi total transaksi untuk efisiensi di terminal
         // *Atau* kita hitung transaksi per hari, yang berarti perlu normalisasi terhadap jumlah hari simulasi.
         // Kita akan menggunakan total transaksi untuk simulasi sederhana.
-        std::map<std::string, int> buyerTransactions;
-        for (const auto &pair : allStoreTransactions)
-        {
-            if (pair.second.getStatus() != TransactionStatus::CANCELLED)
-            {
-                buyerTransactions[pair.second.getBuyerId()]++;
-            }
-        }
+        std::map<Id, int> buyerTransactions = countActiveBy([](const Transaction &t) -> const Id &
+                                                              { return t.getBuyerId(); });
 
-        std::vector<std::pair<int, std::string>> sortedBuyers;
+        std::vector<std::pair<int, Id>> sortedBuyers;
         for (const auto &pair : buyerTransactions)
         {
             sortedBuyers.push_back({pair.second, pair.first});
@@ -338,16 +1094,10 @@ public:
     // 5. List all most active sellers counted by number of transactions per day
     void listMostActiveSellers(int m) const
     {
-        std::map<std::string, int> sellerTransactions;
-        for (const auto &pair : allStoreTransactions)
-        {
-            if (pair.second.getStatus() != TransactionStatus::CANCELLED)
-            {
-                sellerTransactions[pair.second.getSellerId()]++;
-            }
-        }
+        std::map<Id, int> sellerTransactions = countActiveBy([](const Transaction &t) -> const Id &
+                                                              { return t.getSellerId(); });
 
-        std::vector<std::pair<int, std::string>> sortedSellers;
+        std::vector<std::pair<int, Id>> sortedSellers;
         for (const auto &pair : sellerTransactions)
         {
             sortedSellers.push_back({pair.second, pair.first});
@@ -368,21 +1118,37 @@ public:
         if (!seller)
             return;
         time_t oneMonthAgo = DateUtility::getPastMonth();
-        std::map<std::string, int> itemSalesCount;
+        if (analyticsMode == AnalyticsMode::APPROXIMATE)
+        {
+            printApproximateTop("\n--- Top " + std::to_string(k) + " Item Populer Milik Anda Sebulan Terakhir (Perkiraan) ---",
+                                popularity.sellerWindow(seller->getId(), oneMonthAgo), k, "Jumlah Terjual", seller->getId(), oneMonthAgo);
+            return;
+        }
+        std::map<Id, int> itemSalesCount;
 
-        for (const auto &pair : allStoreTransactions)
+        if (analyticsMode == AnalyticsMode::ROLLUP)
         {
-            const auto &t = pair.second;
-            // Filter: Transaksi milik seller ini, terjadi dalam sebulan terakhir, dan tidak dibatalkan
-            if (t.getSellerId() == seller->getId() &&
-                t.getDate() >= oneMonthAgo &&
-                t.getStatus() != TransactionStatus::CANCELLED)
+            forEachSellerDay(seller->getId(), oneMonthAgo, [&](const SellerRollup &day)
+                             {
+                for (const auto &item : day.items)
+                    itemSalesCount[item.first] += static_cast<int>(item.second.units); });
+        }
+        else
+        {
+            for (const auto &pair : allStoreTransactions)
             {
-                itemSalesCount[t.getItemId()] += t.getQuantity();
+                const auto &t = pair.second;
+                // Filter: Transaksi milik seller ini, terjadi dalam sebulan terakhir, dan tidak dibatalkan
+                if (t.getSellerId() == seller->getId() &&
+                    t.getDate() >= oneMonthAgo &&
+                    t.getStatus() != TransactionStatus::CANCELLED)
+                {
+                    itemSalesCount[t.getItemId()] += t.getQuantity();
+                }
             }
         }
 
-        std::vector<std::pair<int, std::string>> sortedItems;
+        std::vector<std::pair<int, Id>> sortedItems;
         for (const auto &pair : itemSalesCount)
         {
             sortedItems.push_back({pair.second, pair.first});
@@ -393,7 +1159,8 @@ public:
         for (int i = 0; i < std::min((int)sortedItems.size(), k); ++i)
         {
             std::cout << (i + 1) << ". Item ID: " << sortedItems[i].second
-                      << " | Jumlah Terjual: " << sortedItems[i].first << std::endl;
+                      << " | Jumlah Terjual: " << sortedItems[i].first
+                      << " | Buyer Unik: ~" << customerReach.uniqueBuyersOfItem(seller->getId(), sortedItems[i].second, oneMonthAgo) << std::endl;
         }
     }
 
@@ -403,22 +1170,32 @@ public:
         if (!seller)
             return;
         time_t oneMonthAgo = DateUtility::getPastMonth();
-        std::map<std::string, double> buyerSpending; // Buyer ID -> Total Spending
+        std::map<Id, double> buyerSpending; // Buyer ID -> Total Spending
 
-        for (const auto &pair : allStoreTransactions)
+        if (analyticsMode == AnalyticsMode::ROLLUP)
         {
-            const auto &t = pair.second;
-            // Filter: Transaksi milik seller ini, terjadi dalam sebulan terakhir, dan tidak dibatalkan
-            if (t.getSellerId() == seller->getId() &&
-                t.getDate() >= oneMonthAgo &&
-                t.getStatus() != TransactionStatus::CANCELLED)
+            forEachSellerDay(seller->getId(), oneMonthAgo, [&](const SellerRollup &day)
+                             {
+                for (const auto &buyer : day.buyers)
+                    buyerSpending[buyer.first] += buyer.second.amount; });
+        }
+        else
+        {
+            for (const auto &pair : allStoreTransactions)
             {
-                buyerSpending[t.getBuyerId()] += t.getAmount();
+                const auto &t = pair.second;
+                // Filter: Transaksi milik seller ini, terjadi dalam sebulan terakhir, dan tidak dibatalkan
+                if (t.getSellerId() == seller->getId() &&
+                    t.getDate() >= oneMonthAgo &&
+                    t.getStatus() != TransactionStatus::CANCELLED)
+                {
+                    buyerSpending[t.getBuyerId()] += t.getAmount();
+                }
             }
         }
 
         // Cari pembeli dengan pengeluaran tertinggi
-        std::string loyalBuyerId = "N/A";
+        Id loyalBuyerId = "N/A";
         double maxSpending = -1.0;
         for (const auto &pair : buyerSpending)
         {
@@ -438,6 +1215,8 @@ public:
         {
             std::cout << "Belum ada transaksi bulan ini." << std::endl;
         }
+        std::cout << "Perkiraan jumlah buyer unik bulan ini: ~"
+                  << customerReach.uniqueBuyersOfSeller(seller->getId(), oneMonthAgo) << std::endl;
     }
 };
 
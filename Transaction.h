@@ -5,6 +5,7 @@
 
 #include <string>
 #include "DateUtility.h"
+#include "Id.h"
 
 // Enum untuk Status Transaksi (lebih baik daripada string)
 enum class TransactionStatus
@@ -25,10 +26,10 @@ enum class TransactionType
 class Transaction
 {
 private:
-    std::string transactionId;
-    std::string itemId;
-    std::string buyerId;
-    std::string sellerId;
+    Id transactionId;
+    Id itemId;
+    Id buyerId;
+    Id sellerId;
     double amount;
     int quantity;
     time_t date;
@@ -37,24 +38,30 @@ private:
 
 public:
     // Konstruktor untuk transaksi toko (Pembelian)
-    Transaction(const std::string &tId, const std::string &iId, const std::string &bId, const std::string &sId,
+    Transaction(const Id &tId, const Id &iId, const Id &bId, const Id &sId,
                 double amt, int qty)
         : transactionId(tId), itemId(iId), buyerId(bId), sellerId(sId),
           amount(amt), quantity(qty), date(DateUtility::getCurrentTime()),
           status(TransactionStatus::PAID), type(TransactionType::PURCHASE) {}
 
     // Konstruktor untuk transaksi Bank (Topup/Withdraw)
-    Transaction(const std::string &tId, const std::string &uId, double amt,
+    Transaction(const Id &tId, const Id &uId, double amt,
                 TransactionType t)
         : transactionId(tId), itemId("N/A"), buyerId(uId), sellerId("N/A"),
           amount(amt), quantity(1), date(DateUtility::getCurrentTime()),
           status(TransactionStatus::COMPLETED), type(t) {}
 
+    // Konstruktor lengkap (rekonstruksi dari file) dengan waktu dan status eksplisit
+    Transaction(const Id &tId, const Id &iId, const Id &bId, const Id &sId,
+                double amt, int qty, time_t d, TransactionStatus st, TransactionType t)
+        : transactionId(tId), itemId(iId), buyerId(bId), sellerId(sId),
+          amount(amt), quantity(qty), date(d), status(st), type(t) {}
+
     // Getter
-    std::string getId() const { return transactionId; }
-    std::string getItemId() const { return itemId; }
-    std::string getBuyerId() const { return buyerId; }
-    std::string getSellerId() const { return sellerId; }
+    const Id &getId() const { return transactionId; }
+    const Id &getItemId() const { return itemId; }
+    const Id &getBuyerId() const { return buyerId; }
+    const Id &getSellerId() const { return sellerId; }
     double getAmount() const { return amount; }
     time_t getDate() const { return date; }
     TransactionStatus getStatus() const { return status; }
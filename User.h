@@ -6,18 +6,20 @@
 #include <string>
 #include <memory>
 #include "BankAccount.h"
+#include "ChangeTracker.h"
 
 class User
 {
 protected:
-    std::string userId;
+    Id userId;
     std::string username;
     std::string password;
-    std::string bankAccountId;
+    Id bankAccountId;
     std::shared_ptr<BankAccount> account; // Smart pointer untuk kepemilikan Akun Bank
+    uint64_t version = 0;                 // Naik setiap data user berubah (untuk checkpoint inkremental)
 
 public:
-    User(const std::string &id, const std::string &user, const std::string &pass)
+    User(const Id &id, const std::string &user, const std::string &pass)
         : userId(id), username(user), password(pass)
     {
         // Akun Bank dibuat terpisah/diinject, di sini hanya inisialisasi ID
@@ -26,23 +28,31 @@ public:
     }
 
     // Getter
-    std::string getId() const { return userId; }
-    std::string getUsername() const { return username; }
-    std::string getBankAccountId() const { return bankAccountId; }
+    const Id &getId() const { return userId; }
+    const std::string &getUsername() const { return username; }
+    const Id &getBankAccountId() const { return bankAccountId; }
     std::shared_ptr<BankAccount> getAccount() const { return account; }
+    uint64_t getVersion() const { return version; }
+
+    // Tandai data user berubah sejak checkpoint terakhir
+    void markDirty()
+    {
+        version++;
+        ChangeTracker::getInstance().markUser(userId);
+    }
 
     // Setter (Digunakan oleh Bank untuk menetapkan akun yang terdaftar)
     void setAccount(std::shared_ptr<BankAccount> acc) { account = acc; }
 
     // Fitur Bank yang dimiliki Buyer/Seller [cite: 28]
-    bool topup(double amount, const std::string &tId)
+    bool topup(double amount, const Id &tId)
     { // Topup [cite: 29]
         if (account)
             return account->topup(amount, tId);
         return false;
     }
 
-    bool withdraw(double amount, const std::string &tId)
+    bool withdraw(double amount, const Id &tId)
     { // Withdraw [cite: 30]
         if (account)
             return account->withdraw(amount, tId);
@@ -72,6 +82,12 @@ public:
         std::cout << "Saldo Saat Ini: " << account->getBalance() << std::endl;
     }
 
+    // Byte heap string milik User (dipakai memoryBytes di subkelas; ID disimpan inline)
+    size_t stringHeapBytes() const
+    {
+        return MemoryFootprint::heap(username) + MemoryFootprint::heap(password);
+    }
+
     // Fungsi verifikasi login
     bool verifyPassword(const std::string &p) const
     {
@@ -81,6 +97,12 @@ public:
     // Metode virtual untuk serialisasi (wajib diimplementasikan di subkelas)
     virtual std::string toString() const = 0; // Pure virtual
 
+    // Salinan objek (digunakan untuk snapshot), wajib diimplementasikan di subkelas
+    virtual std::shared_ptr<User> clone() const = 0;
+
+    // Perkiraan byte yang dimiliki user: alokasi objek (make_shared) + data heap, tanpa item seller dan akun bank
+    virtual size_t memoryBytes() const = 0;
+
     // Destructor virtual
     virtual ~User() = default;
 };
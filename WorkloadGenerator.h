@@ -0,0 +1,186 @@
+// File: WorkloadGenerator.h
+
+#ifndef WORKLOADGENERATOR_H
+#define WORKLOADGENERATOR_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+#include "Store.h"
+#include "Bank.h"
+
+// Konfigurasi data sintetis
+struct WorkloadConfig
+{
+    size_t buyers = 1000;
+    size_t sellers = 50;
+    size_t itemsPerSeller = 20;
+    size_t transactions = 100000;
+    int historyDays = 30;        // Transaksi tersebar dari historyDays hari lalu sampai sekarang
+    double itemSkew = 1.0;       // Eksponen Zipf popularitas item (0 = seragam)
+    double buyerSkew = 0.8;      // Eksponen Zipf keaktifan buyer (0 = seragam)
+    double completedRate = 0.7;  // Proporsi transaksi COMPLETED
+    double cancelledRate = 0.05; // Proporsi transaksi CANCELLED (sisanya PAID)
+    uint64_t seed = 42;
+};
+
+// Sampler distribusi Zipf atas rank 0..n-1 (rank 0 paling populer).
+// CDF dihitung sekali, sampling O(log n) dengan binary search.
+class ZipfSampler
+{
+private:
+    std::vector<double> cdf;
+
+public:
+    ZipfSampler(size_t n, double exponent)
+    {
+        cdf.resize(n);
+        double total = 0.0;
+        for (size_t k = 0; k < n; ++k)
+        {
+            total += 1.0 / std::pow(static_cast<double>(k + 1), exponent);
+            cdf[k] = total;
+        }
+        for (double &c : cdf)
+            c /= total;
+    }
+
+    template <typename Rng>
+    size_t operator()(Rng &rng) const
+    {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        size_t k = static_cast<size_t>(std::lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin());
+        return std::min(k, cdf.size() - 1);
+    }
+};
+
+// Generator data historis: membuat buyer, seller beserta item, dan transaksi dengan timestamp lampau.
+// Data dimasukkan lewat jalur pemulihan Store/Bank (tanpa output konsol per record), sehingga
+// fitur berbasis waktu (loyal customer, dormant account, top user hari ini) bisa diuji pada skala besar.
+// Jalur pemulihan tidak menandai ChangeTracker per record, jadi pemanggil wajib menyimpan snapshot penuh sesudahnya.
+class WorkloadGenerator
+{
+public:
+    struct Result
+    {
+        size_t users = 0;
+        size_t items = 0;
+        size_t transactions = 0;
+        size_t topups = 0;
+        double seconds = 0.0;
+    };
+
+    static Result generate(const WorkloadConfig &config)
+    {
+        auto started = std::chrono::steady_clock::now();
+        Result result;
+        if (config.buyers == 0 || config.sellers == 0 || config.itemsPerSeller == 0)
+            return result;
+
+        Store &store = Store::getInstance();
+        Bank &bank = Bank::getInstance();
+        std::mt19937_64 rng(config.seed);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+        // 1. Buat user (ID melanjutkan skema "U<n>" milik registerUser)
+        size_t nextUser = store.getUsers().size() + 1;
+        std::vector<BuyerPtr> buyers;
+        std::vector<SellerPtr> sellers;
+        buyers.reserve(config.buyers);
+        sellers.reserve(config.sellers);
+        for (size_t i = 0; i < config.sellers; ++i, ++nextUser)
+        {
+            Id id = Id::numbered("U", nextUser);
+            auto seller = std::make_shared<Seller>(id, "gen_seller" + std::to_string(nextUser), "pw");
+            for (size_t k = 0; k < config.itemsPerSeller; ++k)
+            {
+                double price = static_cast<double>(1 + rng() % 500);
+                seller->restoreItem(Item("G" + std::to_string(nextUser) + "_" + std::to_string(k),
+                                         "Item " + std::to_string(k), price, 1000000000));
+            }
+            store.restoreUser(seller);
+            sellers.push_back(seller);
+        }
+        for (size_t i = 0; i < config.buyers; ++i, ++nextUser)
+        {
+            Id id = Id::numbered("U", nextUser);
+            auto buyer = std::make_shared<Buyer>(id, "gen_buyer" + std::to_string(nextUser), "pw");
+            store.restoreUser(buyer);
+            buyers.push_back(buyer);
+        }
+        result.users = buyers.size() + sellers.size();
+
+        // Daftar item global; urutan diacak agar item populer tersebar di banyak seller
+        std::vector<std::pair<Seller *, Item *>> catalog;
+        for (const SellerPtr &seller : sellers)
+        {
+            for (const auto &pair : seller->getAllItems())
+                catalog.emplace_back(seller.get(), seller->getItem(pair.first));
+        }
+        std::shuffle(catalog.begin(), catalog.end(), rng);
+        std::shuffle(buyers.begin(), buyers.end(), rng);
+        result.items = catalog.size();
+
+        ZipfSampler itemSampler(catalog.size(), config.itemSkew);
+        ZipfSampler buyerSampler(buyers.size(), config.buyerSkew);
+
+        // 2. Transaksi dengan waktu menaik: jarak antar transaksi berdistribusi eksponensial
+        time_t now = DateUtility::getCurrentTime();
+        time_t start = now - static_cast<time_t>(config.historyDays) * 86400;
+        double meanGap = config.transactions ? static_cast<double>(now - start) / config.transactions : 0.0;
+        std::exponential_distribution<double> gap(meanGap > 0 ? 1.0 / meanGap : 1.0);
+        double clock = static_cast<double>(start);
+
+        for (size_t i = 0; i < config.transactions; ++i)
+        {
+            clock = std::min(clock + (meanGap > 0 ? gap(rng) : 0.0), static_cast<double>(now));
+            time_t date = static_cast<time_t>(clock);
+
+            Buyer *buyer = buyers[buyerSampler(rng)].get();
+            auto &entry = catalog[itemSampler(rng)];
+            Seller *seller = entry.first;
+            Item *item = entry.second;
+            int quantity = 1 + static_cast<int>(rng() % 3);
+            double amount = item->getPrice() * quantity;
+
+            double r = unit(rng);
+            TransactionStatus status = r < config.cancelledRate                            ? TransactionStatus::CANCELLED
+                                       : r < config.cancelledRate + config.completedRate ? TransactionStatus::COMPLETED
+                                                                                          : TransactionStatus::PAID;
+
+            Id tId = store.allocateTransactionId(); // Tidak bentrok dengan transaksi yang sudah ada / diimpor
+            store.replayTransaction(Transaction(tId, item->getId(), buyer->getId(), seller->getId(),
+                                                amount, quantity, date, status, TransactionType::PURCHASE));
+            buyer->restoreOrderId(tId);
+            if (status == TransactionStatus::CANCELLED)
+                continue; // Dana sudah dikembalikan, stok dipulihkan
+
+            if (item->reserveStock(quantity))
+                item->commitReservation(quantity);
+
+            // Pastikan buyer punya saldo: topup sebelum membayar
+            BankAccount *buyerAcc = buyer->getAccount().get();
+            if (buyerAcc->getBalance() < amount)
+            {
+                double topup = std::ceil(amount / 100.0) * 100.0 + 100.0 * static_cast<double>(rng() % 10);
+                Transaction topupTx(Id::numbered("T", bank.getTransactionCount() + 1), "N/A", buyer->getId(), "N/A",
+                                    topup, 1, date, TransactionStatus::COMPLETED, TransactionType::TOPUP);
+                bank.recordHistoricalTransaction(*buyerAcc, topupTx);
+                result.topups++;
+            }
+
+            // Pergerakan dana seperti Bank::transfer: satu entri Ledger, debit buyer dan kredit seller
+            BankAccount::recordHistoricalTransfer(buyerAcc, seller->getAccount().get(), amount, tId, date, TransactionType::PURCHASE);
+        }
+        store.rebuildSketches();
+        ChangeTracker::getInstance().markAll();
+        result.transactions = config.transactions;
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        return result;
+    }
+};
+
+#endif // WORKLOADGENERATOR_H
@@ -4,6 +4,8 @@
 #include <limits>
 #include "Store.h"
 #include "DataPersistence.h"
+#include "WorkloadGenerator.h"
+#include "Server.h"
 
 // --- Global Pointers ---
 UserPtr current_user = nullptr;
@@ -61,7 +63,8 @@ void menu_buyer()
         std::cout << "4. Purchase Item" << std::endl;
         std::cout << "5. List All Orders" << std::endl;
         std::cout << "6. Check Spending (k Days)" << std::endl;
-        std::cout << "7. Logout" << std::endl;
+        std::cout << "7. Cari Item (Nama)" << std::endl;
+        std::cout << "8. Logout" << std::endl;
         std::cout << "Pilih Opsi: ";
 
         if (!(std::cin >> choice))
@@ -118,6 +121,7 @@ void menu_buyer()
             int qty;
             std::cout << "Masukkan Item ID yang akan dibeli: ";
             std::getline(std::cin, itemId);
+            Store::getInstance().listOffers(itemId);
             qty = get_int_input("Masukkan kuantitas: ");
             Store::getInstance().purchaseItem(buyer, itemId, qty);
             break;
@@ -147,13 +151,32 @@ void menu_buyer()
             break;
         }
         case 7:
+        { // Cari Item
+            std::string query;
+            std::cout << "Kata kunci nama item: ";
+            std::getline(std::cin, query);
+            int page = 1;
+            while (page > 0)
+            {
+                Store::getInstance().searchItems(query, static_cast<size_t>(page), 10);
+                std::cout << "Halaman lain (0 untuk selesai): ";
+                if (!(std::cin >> page))
+                {
+                    page = 0;
+                    std::cin.clear();
+                }
+                clear_input();
+            }
+            break;
+        }
+        case 8:
             current_user = nullptr;
             std::cout << "Anda telah logout." << std::endl;
             break;
         default:
             std::cout << "Pilihan tidak valid." << std::endl;
         }
-    } while (choice != 7);
+    } while (choice != 8);
 }
 
 void menu_seller()
@@ -173,7 +196,8 @@ void menu_seller()
         std::cout << "2. Manage Items (Register/Replenish/Discard)" << std::endl;
         std::cout << "3. Discover Top K Popular Items (Per Month)" << std::endl;
         std::cout << "4. Discover Loyal Customer (Per Month)" << std::endl;
-        std::cout << "5. Logout" << std::endl;
+        std::cout << "5. Low-Stock Watch List" << std::endl;
+        std::cout << "6. Logout" << std::endl;
         std::cout << "Pilih Opsi: ";
 
         if (!(std::cin >> choice))
@@ -210,8 +234,8 @@ void menu_seller()
                 std::getline(std::cin, name);
                 price = get_double_input("Harga per item: ");
                 stock = get_int_input("Stok awal: ");
-                seller->registerNewItem(itemId, name, price, stock);
-                std::cout << "Item '" << name << "' berhasil didaftarkan." << std::endl;
+                if (Store::getInstance().registerItem(seller, itemId, name, price, stock))
+                    std::cout << "Item '" << name << "' berhasil didaftarkan." << std::endl;
             }
             else if (subChoice == 2)
             {
@@ -220,7 +244,7 @@ void menu_seller()
                 std::cout << "Item ID yang akan ditambah: ";
                 std::getline(std::cin, itemId);
                 qty = get_int_input("Jumlah stok yang akan ditambahkan: ");
-                if (seller->replenishStock(itemId, qty))
+                if (Store::getInstance().replenishStock(seller, itemId, qty))
                 {
                     std::cout << "Stok item berhasil diperbarui." << std::endl;
                 }
@@ -236,7 +260,7 @@ void menu_seller()
                 std::cout << "Item ID yang akan dibuang: ";
                 std::getline(std::cin, itemId);
                 qty = get_int_input("Jumlah stok yang akan dibuang: ");
-                if (seller->discardStock(itemId, qty))
+                if (Store::getInstance().discardStock(seller, itemId, qty))
                 {
                     std::cout << "Stok item berhasil dibuang." << std::endl;
                 }
@@ -259,13 +283,31 @@ void menu_seller()
             break;
         }
         case 5:
+        { // Low-Stock Watch List
+            seller->displayLowStock();
+            int threshold;
+            std::cout << "Threshold baru (saat ini " << seller->getLowStockThreshold() << ", -1 untuk tidak mengubah): ";
+            if (!(std::cin >> threshold))
+            {
+                threshold = -1;
+                std::cin.clear();
+            }
+            clear_input();
+            if (threshold >= 0)
+            {
+                seller->setLowStockThreshold(threshold);
+                seller->displayLowStock();
+            }
+            break;
+        }
+        case 6:
             current_user = nullptr;
             std::cout << "Anda telah logout." << std::endl;
             break;
         default:
             std::cout << "Pilihan tidak valid." << std::endl;
         }
-    } while (choice != 5);
+    } while (choice != 6);
 }
 
 void menu_store_bank_management()
@@ -283,7 +325,20 @@ void menu_store_bank_management()
         std::cout << "7. Bank: List All Customers" << std::endl;
         std::cout << "8. Bank: List Dormant Accounts" << std::endl;
         std::cout << "9. Bank: List Top N Users Today" << std::endl;
-        std::cout << "10. Kembali ke Main Menu" << std::endl;
+        std::cout << "10. Complete Order" << std::endl;
+        std::cout << "11. Cancel Order (PAID)" << std::endl;
+        std::cout << "12. Refund Order (COMPLETED)" << std::endl;
+        std::cout << "13. Complete All Paid Orders" << std::endl;
+        std::cout << "14. Simpan Snapshot (Background)" << std::endl;
+        std::cout << "15. Checkpoint Inkremental" << std::endl;
+        std::cout << "16. Padatkan Log Checkpoint" << std::endl;
+        std::cout << "17. Tampilkan & Ekspor Metrics" << std::endl;
+        std::cout << "18. Generate Data Sintetis (Historis)" << std::endl;
+        std::cout << "19. Impor Histori Transaksi (CSV/Ledger)" << std::endl;
+        std::cout << "20. Ganti Mode Analitik (Exact/Perkiraan/Rollup Harian)" << std::endl;
+        std::cout << "21. Laporan Pemakaian Memori" << std::endl;
+        std::cout << "22. Atur Retensi Cash Flow" << std::endl;
+        std::cout << "23. Kembali ke Main Menu" << std::endl;
         std::cout << "Pilih Opsi: ";
 
         if (!(std::cin >> choice))
@@ -338,11 +393,171 @@ void menu_store_bank_management()
             break;
         }
         case 10:
+        { // Complete Order
+            std::string tId;
+            std::cout << "Masukkan Transaction ID: ";
+            std::getline(std::cin, tId);
+            Store::getInstance().completeOrder(tId);
+            break;
+        }
+        case 11:
+        { // Cancel Order
+            std::string tId;
+            std::cout << "Masukkan Transaction ID: ";
+            std::getline(std::cin, tId);
+            Store::getInstance().cancelOrder(tId);
+            break;
+        }
+        case 12:
+        { // Refund Order
+            std::string tId;
+            std::cout << "Masukkan Transaction ID: ";
+            std::getline(std::cin, tId);
+            Store::getInstance().refundOrder(tId);
+            break;
+        }
+        case 13:
+        { // Complete All Paid Orders
+            int count = Store::getInstance().completeAllPaidOrders();
+            std::cout << count << " pesanan ditandai COMPLETED." << std::endl;
+            break;
+        }
+        case 14:
+        { // Simpan Snapshot (Background)
+            uint64_t journalPosition = 0;
+            if (DataPersistence::saveDataAsync(journalPosition))
+            {
+                std::cout << "Snapshot dimulai di background (journal " << journalPosition << ")." << std::endl;
+            }
+            else
+            {
+                std::cout << "Snapshot sebelumnya masih berjalan." << std::endl;
+            }
+            break;
+        }
+        case 15:
+        { // Checkpoint Inkremental
+            size_t written = DataPersistence::saveIncremental();
+            std::cout << "Checkpoint selesai: " << written << " record berubah ditulis." << std::endl;
+            break;
+        }
+        case 16: // Padatkan Log Checkpoint
+            DataPersistence::compactCheckpointLog();
+            break;
+        case 17: // Tampilkan & Ekspor Metrics
+            Metrics::getInstance().display();
+            if (DataPersistence::exportMetrics())
+            {
+                std::cout << "Metrics diekspor ke metrics.prom (format Prometheus)." << std::endl;
+            }
+            else
+            {
+                std::cout << "Gagal mengekspor metrics." << std::endl;
+            }
+            break;
+        case 18:
+        { // Generate Data Sintetis
+            int buyers = get_int_input("Jumlah buyer: ");
+            int sellers = get_int_input("Jumlah seller: ");
+            int items = get_int_input("Jumlah item per seller: ");
+            int transactions = get_int_input("Jumlah transaksi: ");
+            int days = get_int_input("Rentang histori (hari): ");
+            WorkloadConfig config;
+            config.buyers = buyers;
+            config.sellers = sellers;
+            config.itemsPerSeller = items;
+            config.transactions = transactions;
+            config.historyDays = days;
+            WorkloadGenerator::Result result = WorkloadGenerator::generate(config);
+            std::cout << "Data sintetis dibuat: " << result.users << " user, " << result.items << " item, "
+                      << result.transactions << " transaksi, " << result.topups << " topup ("
+                      << result.seconds << " detik)." << std::endl;
+            // Sama seperti impor: data generator tidak tercatat di log checkpoint, jadi langsung simpan snapshot penuh
+            DataPersistence::saveData();
+            break;
+        }
+        case 19:
+        { // Impor Histori Transaksi
+            std::string path;
+            std::cout << "Path file histori: ";
+            std::getline(std::cin, path);
+            DataPersistence::ImportResult result;
+            if (!DataPersistence::importHistory(path, result))
+            {
+                std::cout << "Gagal membuka file " << path << std::endl;
+                break;
+            }
+            std::cout << "Impor selesai: " << result.storeTransactions << " transaksi toko, "
+                      << result.bankTransactions << " transaksi bank, " << result.rejected
+                      << " ditolak (ID transaksi sudah ada / akun tidak ditemukan / tanda jumlah tidak sesuai tipe)." << std::endl;
+            // Data impor tidak tercatat di log checkpoint, jadi langsung simpan snapshot penuh
+            DataPersistence::saveData();
+            break;
+        }
+        case 20:
+        { // Ganti Mode Analitik
+            Store &store = Store::getInstance();
+            // Urutan: EXACT -> PERKIRAAN -> ROLLUP -> EXACT
+            AnalyticsMode mode = store.getAnalyticsMode();
+            AnalyticsMode next = mode == AnalyticsMode::EXACT         ? AnalyticsMode::APPROXIMATE
+                                 : mode == AnalyticsMode::APPROXIMATE ? AnalyticsMode::ROLLUP
+                                                                      : AnalyticsMode::EXACT;
+            store.setAnalyticsMode(next);
+            std::cout << "Mode analitik sekarang: "
+                      << (next == AnalyticsMode::EXACT         ? "EXACT (scan ledger)"
+                          : next == AnalyticsMode::APPROXIMATE ? "PERKIRAAN (sketch)"
+                                                               : "ROLLUP (agregat harian, hari penuh)")
+                      << std::endl;
+            break;
+        }
+        case 21:
+        { // Laporan Pemakaian Memori
+            MemoryFootprint::Report report = Store::getInstance().memoryUsage();
+            MemoryFootprint::display(report);
+            if (DataPersistence::exportMemoryReport(report))
+            {
+                std::cout << "Laporan memori diekspor ke memory.csv." << std::endl;
+            }
+            else
+            {
+                std::cout << "Gagal mengekspor laporan memori." << std::endl;
+            }
+            break;
+        }
+        case 22:
+        { // Atur Retensi Cash Flow
+            Bank &bank = Bank::getInstance();
+            std::cout << "Retensi saat ini: ";
+            if (bank.getCashFlowRetentionDays() > 0)
+                std::cout << bank.getCashFlowRetentionDays() << " hari" << (bank.isCashFlowArchived() ? " (diarsipkan)" : "") << std::endl;
+            else
+                std::cout << "tanpa batas" << std::endl;
+            int action = get_int_input("1. Ubah retensi, 2. Nonaktifkan: ");
+            if (action == 2)
+            {
+                bank.setCashFlowRetention(0, false);
+                std::cout << "Retensi cash flow dinonaktifkan." << std::endl;
+                break;
+            }
+            if (action != 1)
+            {
+                std::cout << "Pilihan tidak valid." << std::endl;
+                break;
+            }
+            int days = get_int_input("Retensi (hari, minimal " + std::to_string(Bank::MIN_CASH_FLOW_RETENTION_DAYS) + "): ");
+            int archive = get_int_input("Arsipkan entri lama ke cashflow_archive.log? (1 = Ya, 2 = Tidak): ");
+            bank.setCashFlowRetention(days, archive == 1);
+            size_t folded = DataPersistence::compactCashFlow();
+            std::cout << "Retensi cash flow: " << bank.getCashFlowRetentionDays() << " hari. "
+                      << folded << " entri dipadatkan ke checkpoint bulanan." << std::endl;
+            break;
+        }
+        case 23:
             return;
         default:
             std::cout << "Pilihan tidak valid." << std::endl;
         }
-    } while (choice != 10);
+    } while (choice != 23);
 }
 
 void menu_main()
@@ -432,10 +647,47 @@ void menu_main()
     } while (choice != 5 || current_user); // Lanjutkan loop selama belum memilih keluar atau masih login
 }
 
-int main()
+int main(int argc, char *argv[])
 {
-    // Memuat data saat aplikasi dimulai (Simulasi Data Persistence)
-    DataPersistence::loadData();
+    // Opsi: --server [port | unix:<path>] [--shards N] (default port 7000, tanpa shard)
+    //       --publish <nama>   terbitkan snapshot berkala ke shared memory untuk replica (mode server)
+    //       --replica <nama>   jalankan server read-only dari snapshot primary (tanpa memuat data dari disk)
+    //       --cashflow-retention <hari> [--archive-cashflow] (berlaku di mode konsol & server)
+    bool server = false, archiveCashFlow = false;
+    std::string address = "7000", publishName, replicaName;
+    size_t shards = 0;
+    int retentionDays = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--server")
+            server = true;
+        else if (arg == "--shards" && i + 1 < argc)
+            shards = static_cast<size_t>(std::max(0, std::atoi(argv[++i])));
+        else if (arg == "--publish" && i + 1 < argc)
+            publishName = argv[++i];
+        else if (arg == "--replica" && i + 1 < argc)
+        {
+            replicaName = argv[++i];
+            server = true;
+        }
+        else if (arg == "--cashflow-retention" && i + 1 < argc)
+            retentionDays = std::atoi(argv[++i]);
+        else if (arg == "--archive-cashflow")
+            archiveCashFlow = true;
+        else if (server)
+            address = arg;
+    }
+
+    // Memuat data saat aplikasi dimulai (Simulasi Data Persistence). Replica memuat dari snapshot primary.
+    if (replicaName.empty())
+        DataPersistence::loadData();
+    Bank::getInstance().setCashFlowRetention(retentionDays, archiveCashFlow);
+
+    if (server)
+    {
+        return Server::run(address, shards, publishName, replicaName);
+    }
 
     // Jalankan menu utama
     menu_main();